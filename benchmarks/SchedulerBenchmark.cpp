@@ -0,0 +1,131 @@
+// Copyright 2023 THALES ALENIA SPACE FRANCE. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compare the scheduling backends of XsmpScheduler with a large number of
+// cyclic events, posted one by one or in a single batch, coalesced or not in
+// rate groups, and measure the overhead of the event trace recorder.
+// usage: SchedulerBenchmark [events] [duration in ms]
+
+#include <Smp/PrimitiveTypes.h>
+#include <Smp/Services/TimeKind.h>
+#include <Xsmp/Component.h>
+#include <Xsmp/Duration.h>
+#include <Xsmp/EntryPoint.h>
+#include <Xsmp/EntryPointPublisher.h>
+#include <Xsmp/Services/XsmpScheduler.h>
+#include <Xsmp/Simulator.h>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+namespace {
+class EntryPoints : public Xsmp::Component,
+                    public virtual Xsmp::EntryPointPublisher {
+public:
+  using Xsmp::Component::Component;
+};
+
+struct Result {
+  double postDuration;
+  double runDuration;
+  std::size_t executions;
+};
+
+Result Run(::Smp::Duration tick, std::size_t eventCount,
+           ::Smp::Duration duration, bool batch, bool rateGroups,
+           bool trace = false) {
+  using namespace ::Xsmp::literals;
+  Xsmp::Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Xsmp::Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(100.);
+  scheduler.SetTimingWheelTick(tick);
+  scheduler.SetRateGroupCoalescing(rateGroups);
+
+  EntryPoints entryPoints{"entryPoints", "", &sim};
+  std::size_t executions = 0;
+  ::Xsmp::EntryPoint ep{"ep", "", &entryPoints, [&] { ++executions; }};
+
+  // 1 Hz, 8 Hz, 64 Hz and 512 Hz rate groups
+  static constexpr std::array<::Smp::Duration, 4> cycles{1_s, 125_ms,
+                                                        15625_us, 1953125_ns};
+  auto start = std::chrono::steady_clock::now();
+  if (batch) {
+    std::vector<Xsmp::Services::XsmpScheduler::EventSpec> events;
+    events.reserve(eventCount);
+    for (std::size_t i = 0; i < eventCount; ++i) {
+      events.push_back({&ep, 0, cycles[i % cycles.size()], -1,
+                        ::Smp::Services::TimeKind::TK_SimulationTime});
+    }
+    scheduler.AddEvents(events);
+  } else {
+    for (std::size_t i = 0; i < eventCount; ++i) {
+      scheduler.AddSimulationTimeEvent(&ep, 0, cycles[i % cycles.size()], -1);
+    }
+  }
+  const auto tracePath =
+      (std::filesystem::temp_directory_path() / "SchedulerBenchmark.trace")
+          .string();
+  if (trace) {
+    scheduler.StartTrace(tracePath.c_str());
+  }
+  auto posted = std::chrono::steady_clock::now();
+  sim.Run(duration);
+  auto end = std::chrono::steady_clock::now();
+  if (trace) {
+    scheduler.StopTrace();
+    std::filesystem::remove(tracePath);
+  }
+  sim.Exit();
+
+  return {std::chrono::duration<double>(posted - start).count(),
+          std::chrono::duration<double>(end - posted).count(), executions};
+}
+
+void Print(const char *name, const Result &result) {
+  std::cout << name << ": post " << result.postDuration << " s, run "
+            << result.runDuration << " s, " << result.executions
+            << " executions ("
+            << result.runDuration * 1e9 /
+                   static_cast<double>(result.executions ? result.executions
+                                                         : 1)
+            << " ns/execution)\n";
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  using namespace ::Xsmp::literals;
+  const std::size_t eventCount =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+  const ::Smp::Duration duration =
+      argc > 2 ? std::strtoll(argv[2], nullptr, 10) * 1000000 : 1_s;
+
+  std::cout << eventCount << " cyclic events, " << duration << " ns\n";
+  Print("ordered table        ", Run(0, eventCount, duration, false, false));
+  Print("timing wheel         ",
+        Run(1953125_ns, eventCount, duration, false, false));
+  Print("timing wheel (batch) ",
+        Run(1953125_ns, eventCount, duration, true, false));
+  Print("rate groups          ",
+        Run(1953125_ns, eventCount, duration, false, true));
+  Print("timing wheel (traced)",
+        Run(1953125_ns, eventCount, duration, false, false, true));
+  return EXIT_SUCCESS;
+}
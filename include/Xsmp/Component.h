@@ -59,7 +59,7 @@ public:
                      ::Smp::ISimulator *simulator = nullptr);
 
   /// Virtual destructor to release memory.
-  ~Component() noexcept override = default;
+  ~Component() noexcept override;
 
   /// Return the name of the object.
   /// @return  Name of object.
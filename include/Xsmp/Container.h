@@ -47,7 +47,7 @@ public:
                     ::Smp::Int64 upper);
 
   /// Virtual destructor to release memory.
-  ~AbstractContainer() noexcept override = default;
+  ~AbstractContainer() noexcept override;
 
   /// Return the name of the container.
   /// @return  Name of object.
@@ -51,7 +51,7 @@ public:
              ::Smp::IObject *parent, std::function<void()> &&callback);
 
   /// Virtual destructor to release memory.
-  ~EntryPoint() noexcept override = default;
+  ~EntryPoint() noexcept override;
 
   /// Return the name of the entry point.
   /// @return  Name of entry point.
@@ -37,7 +37,7 @@ public:
                     ::Smp::IObject *parent);
   AbstractEventSink(const AbstractEventSink &) = delete;
   AbstractEventSink &operator=(const AbstractEventSink &) = delete;
-  ~AbstractEventSink() noexcept override = default;
+  ~AbstractEventSink() noexcept override;
   ::Smp::String8 GetName() const final;
   ::Smp::String8 GetDescription() const final;
   ::Smp::IObject *GetParent() const final;
@@ -44,7 +44,7 @@ public:
                       ::Smp::PrimitiveTypeKind eventArgType);
   AbstractEventSource(const AbstractEventSource &) = delete;
   AbstractEventSource &operator=(const AbstractEventSource &) = delete;
-  ~AbstractEventSource() noexcept override = default;
+  ~AbstractEventSource() noexcept override;
   ::Smp::String8 GetName() const final;
   ::Smp::String8 GetDescription() const final;
   ::Smp::IObject *GetParent() const final;
@@ -80,7 +80,7 @@ public:
   }
 
   /// Virtual destructor to release memory.
-  ~Factory() noexcept override = default;
+  ~Factory() noexcept override;
 
   /// Get the name of the factory
   /// @return  the name of the factory.
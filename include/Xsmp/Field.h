@@ -284,7 +284,7 @@ class AbstractField : public virtual ::Smp::IField {
 public:
   AbstractField(const AbstractField &) = delete;
   AbstractField &operator=(const AbstractField &) = delete;
-  ~AbstractField() noexcept override = default;
+  ~AbstractField() noexcept override;
   ::Smp::String8 GetName() const final;
   ::Smp::String8 GetDescription() const final;
   ::Smp::IObject *GetParent() const final;
@@ -19,6 +19,8 @@
 #include <Smp/IField.h>
 #include <Smp/IObject.h>
 #include <Smp/PrimitiveTypes.h>
+#include <Smp/Services/EventId.h>
+#include <Smp/Services/LogMessageKind.h>
 #include <Xsmp/cstring.h>
 #include <array>
 #include <cstddef>
@@ -36,8 +38,51 @@ class IEntryPoint;
 class IField;
 class ISimulator;
 template <typename> class ICollection;
+namespace Services {
+class IEventManager;
+class ILogger;
+} // namespace Services
 } // namespace Smp
 
+namespace Xsmp {
+/// Optional interface of a logger that can tell in advance whether a message
+/// would be written, so that callers can skip building it.
+class ILogFilter {
+public:
+  virtual ~ILogFilter() noexcept = default;
+
+  /// Check whether a message of a given kind from a given sender is logged.
+  /// @param sender Object that would send the message.
+  /// @param kind Kind of message.
+  /// @return False if the message would be discarded, true otherwise.
+  [[nodiscard]] virtual bool
+  IsLogEnabled(const ::Smp::IObject *sender,
+               ::Smp::Services::LogMessageKind kind) const noexcept = 0;
+};
+
+/// Optional interface of an event manager that orders the subscribers of a
+/// global event by priority and executes the asynchronous emissions in the
+/// background.
+class IEventDispatcher {
+public:
+  virtual ~IEventDispatcher() noexcept = default;
+
+  /// Subscribe entry point to a global event with a priority.
+  /// Entry points are called by decreasing priority, then in the order they
+  /// have been subscribed.
+  /// @param event Event identifier of global event to subscribe to.
+  /// @param entryPoint Entry point to subscribe to global event.
+  /// @param priority Priority of the entry point.
+  virtual void Subscribe(::Smp::Services::EventId event,
+                         const ::Smp::IEntryPoint *entryPoint,
+                         ::Smp::Int32 priority) = 0;
+
+  /// Wait until all the pending asynchronous emissions are executed.
+  /// This method does nothing when called from an asynchronous emission.
+  virtual void Flush() = 0;
+};
+} // namespace Xsmp
+
 /// XSMP standard types and interfaces.
 namespace Xsmp::
     /// XSMP helpers.
@@ -62,11 +107,69 @@ constexpr auto auto_cast(U *element)
 void SafeExecute(::Smp::ISimulator *simulator,
                  const ::Smp::IEntryPoint *entryPoint);
 
+/// Check whether a logger would write a message of a given kind from a
+/// given sender.
+/// Hot callers should check it before formatting their message.
+/// @param logger The logger.
+/// @param sender Object that would send the message.
+/// @param kind Kind of message.
+/// @return False if the logger implements ILogFilter and discards the
+/// message, true otherwise.
+[[nodiscard]] bool IsLogEnabled(const ::Smp::Services::ILogger *logger,
+                                const ::Smp::IObject *sender,
+                                ::Smp::Services::LogMessageKind kind) noexcept;
+
+/// Execute a sequence of EntryPoints within a single exception guard.
+/// If an exception is raised by an entry point, the Simulation is aborted,
+/// the exception is logged with the failing entry point and the following
+/// entry points are executed.
+/// @param simulator The simulator.
+/// @param entryPoints The entry points to execute.
+/// @param count The number of entry points.
+void SafeExecute(::Smp::ISimulator *simulator,
+                 const ::Smp::IEntryPoint *const *entryPoints,
+                 std::size_t count);
+
+/// Subscribe entry point to a global event with a priority.
+/// The priority is ignored if the event manager does not implement
+/// IEventDispatcher.
+/// @param eventManager The event manager.
+/// @param event Event identifier of global event to subscribe to.
+/// @param entryPoint Entry point to subscribe to global event.
+/// @param priority Priority of the entry point.
+void Subscribe(::Smp::Services::IEventManager *eventManager,
+               ::Smp::Services::EventId event,
+               const ::Smp::IEntryPoint *entryPoint, ::Smp::Int32 priority);
+
+/// Wait until all the pending asynchronous emissions of an event manager are
+/// executed.
+/// @param eventManager The event manager.
+void FlushEvents(::Smp::Services::IEventManager *eventManager);
+
 /// Get the path of an object in the Smp::IObject hierarchy.
 /// @param obj A pointer to the object for which to retrieve the path.
 /// @return The path of the object as a std::string.
 [[nodiscard]] std::string GetPath(const ::Smp::IObject *obj);
 
+/// Get the path of an object in the Smp::IObject hierarchy from a per-thread
+/// cache, for the hot paths of the logger and of the exceptions.
+/// The path of an object is evicted by ForgetPath() and an entry is computed
+/// again if the parent or the name of the object changed.
+/// @param obj A pointer to the object for which to retrieve the path.
+/// @return The path of the object, valid until the next call from the same
+/// thread.
+[[nodiscard]] const std::string &GetCachedPath(const ::Smp::IObject *obj);
+
+/// Evict the cached path of an object from the caches of all the threads.
+/// It is called by the destructors of the Xsmp objects, other implementations
+/// of Smp::IObject must call it when they are deleted.
+/// @param obj The deleted object.
+void ForgetPath(const ::Smp::IObject *obj) noexcept;
+
+/// Clear the cached paths of all the threads.
+/// It must be called when objects of the hierarchy may have moved.
+void InvalidatePaths() noexcept;
+
 [[nodiscard]] ::Smp::IObject *
 Resolve(const ::Smp::ICollection<Smp::IField> *fields, ::Smp::String8 path);
 [[nodiscard]] ::Smp::IObject *Resolve(::Smp::IObject *parent,
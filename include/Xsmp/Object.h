@@ -35,7 +35,7 @@ public:
                   ::Smp::IObject *parent = nullptr);
 
   /// Virtual destructor to release memory.
-  ~Object() noexcept override = default;
+  ~Object() noexcept override;
 
   /// Return the name of the object.
   /// @return  Name of object.
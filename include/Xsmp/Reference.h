@@ -45,7 +45,7 @@ public:
                     ::Smp::Int64 upper);
   AbstractReference(const AbstractReference &) = delete;
   AbstractReference &operator=(const AbstractReference &) = delete;
-  ~AbstractReference() noexcept override = default;
+  ~AbstractReference() noexcept override;
   ::Smp::String8 GetName() const final;
   ::Smp::String8 GetDescription() const final;
   ::Smp::IObject *GetParent() const final;
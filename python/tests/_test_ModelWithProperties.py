@@ -34,6 +34,14 @@ class Simulator(ecss_smp.Smp.ISimulator, ):
         HoldEvent: ecss_smp.Smp.IEntryPoint
         EnterExecuting: ecss_smp.Smp.IEntryPoint
         LeaveExecuting: ecss_smp.Smp.IEntryPoint
+        FreeRunning: ecss_smp.Smp.IProperty
+        Profiling: ecss_smp.Smp.IProperty
+        Load: ecss_smp.Smp.IProperty
+        Speed: ecss_smp.Smp.IProperty
+        OverrunPolicy: ecss_smp.Smp.IProperty
+        OverrunTolerance: ecss_smp.Smp.IProperty
+        OverrunCount: ecss_smp.Smp.IProperty
+        MaxLateness: ecss_smp.Smp.IProperty
 
     XsmpScheduler: __XsmpScheduler
 
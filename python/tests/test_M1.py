@@ -13,6 +13,8 @@
 # limitations under the License.
 
 
+import os
+import tempfile
 import unittest
 import ecss_smp
 import xsmp_tests
@@ -87,6 +89,44 @@ class TestM1(xsmp.unittest.TestCase):
         time_keeper = self.sim.GetTimeKeeper()
         self.assertEqual(time_keeper, self.sim.XsmpTimeKeeper)
 
+    def testScheduler(self):
+        scheduler = self.sim.XsmpScheduler
+        self.assertEqual(scheduler, self.sim.GetScheduler())
+        self.assertFalse(scheduler.FreeRunning)
+        scheduler.FreeRunning = True
+        self.assertTrue(scheduler.FreeRunning)
+        self.assertTrue(scheduler.FreeRunning.GetValue())
+        scheduler.FreeRunning.SetValue(False)
+        self.assertFalse(scheduler.FreeRunning)
+        self.assertFalse(scheduler.Profiling)
+        scheduler.Profiling = True
+        self.assertTrue(scheduler.Profiling)
+        scheduler.Profiling = False
+
+        # step to the next event boundary
+        time = self.sim.GetTimeKeeper().GetSimulationTime() + 10_000_000
+        scheduler.AddSimulationTimeEvent(scheduler.HoldEvent, time, 0, 0)
+        self.assertEqual(scheduler.Lookahead(5), 1)
+        self.assertEqual(scheduler.GetLookaheadTime(0), time)
+        self.assertTrue(scheduler.GetLookaheadEntryPoint(0).endswith("XsmpScheduler.HoldEvent"))
+        scheduler.FreeRunning = True
+        self.assertEqual(scheduler.RunToNextEvent(), time)
+        self.assertEqual(scheduler.Step(1_000_000), time + 1_000_000)
+        self.assertEqual(scheduler.RunUntil(time + 5_000_000), time + 5_000_000)
+        scheduler.FreeRunning = False
+        self.assertEqual(scheduler.Lookahead(5), 0)
+
+        # record the executed events
+        with tempfile.TemporaryDirectory() as directory:
+            trace = os.path.join(directory, "trace.bin")
+            scheduler.StartTrace(trace)
+            scheduler.AddImmediateEvent(scheduler.HoldEvent)
+            scheduler.FreeRunning = True
+            scheduler.Step(0)
+            scheduler.FreeRunning = False
+            scheduler.StopTrace()
+            self.assertEqual(scheduler.CompareTrace(trace, trace), "")
+
     def testEvents(self):
         test = self.sim.test
 
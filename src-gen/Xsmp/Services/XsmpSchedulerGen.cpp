@@ -24,6 +24,7 @@
 
 #include <Smp/IPublication.h>
 #include <Xsmp/ComponentHelper.h>
+#include <Xsmp/Request.h>
 #include <Xsmp/Services/XsmpScheduler.h>
 
 namespace Xsmp::Services {
@@ -48,6 +49,212 @@ void XsmpSchedulerGen::Publish(::Smp::IPublication *receiver) {
   // Call parent class implementation first
   ::Xsmp::Service::Publish(receiver);
 
+  // Publish Property FreeRunning
+  receiver->PublishProperty("FreeRunning",
+                            "Execute the events as fast as possible, without "
+                            "synchronization with the Zulu time.",
+                            ::Smp::Uuids::Uuid_Bool,
+                            ::Smp::AccessKind::AK_ReadWrite,
+                            ::Smp::ViewKind::VK_None);
+  // Publish Property Profiling
+  receiver->PublishProperty("Profiling",
+                            "Record the execution time of the entry points "
+                            "executed by the scheduler.",
+                            ::Smp::Uuids::Uuid_Bool,
+                            ::Smp::AccessKind::AK_ReadWrite,
+                            ::Smp::ViewKind::VK_None);
+  // Publish Property Load
+  receiver->PublishProperty(
+      "Load",
+      "Average part of the real time budget used to execute the events.",
+      ::Smp::Uuids::Uuid_Float64, ::Smp::AccessKind::AK_ReadOnly,
+      ::Smp::ViewKind::VK_None);
+  // Publish Property Speed
+  receiver->PublishProperty("Speed",
+                            "Average ratio between the elapsed simulation "
+                            "time and the elapsed Zulu time.",
+                            ::Smp::Uuids::Uuid_Float64,
+                            ::Smp::AccessKind::AK_ReadOnly,
+                            ::Smp::ViewKind::VK_None);
+  // Publish Property OverrunPolicy
+  receiver->PublishProperty(
+      "OverrunPolicy",
+      "Policy applied when a time step misses its Zulu deadline: 0 to catch "
+      "up the lost time, 1 to skip to the current Zulu time, 2 to hold the "
+      "simulation, 3 to emit the XSMP_SchedulerOverrun event.",
+      ::Smp::Uuids::Uuid_Int32, ::Smp::AccessKind::AK_ReadWrite,
+      ::Smp::ViewKind::VK_None);
+  // Publish Property OverrunTolerance
+  receiver->PublishProperty("OverrunTolerance",
+                            "Lateness on the Zulu deadline below which a time "
+                            "step is not an overrun.",
+                            ::Smp::Uuids::Uuid_Duration,
+                            ::Smp::AccessKind::AK_ReadWrite,
+                            ::Smp::ViewKind::VK_None);
+  // Publish Property OverrunCount
+  receiver->PublishProperty(
+      "OverrunCount", "Number of time steps that missed their Zulu deadline.",
+      ::Smp::Uuids::Uuid_Int64, ::Smp::AccessKind::AK_ReadOnly,
+      ::Smp::ViewKind::VK_None);
+  // Publish Property MaxLateness
+  receiver->PublishProperty(
+      "MaxLateness", "Worst lateness of a time step on its Zulu deadline.",
+      ::Smp::Uuids::Uuid_Duration, ::Smp::AccessKind::AK_ReadOnly,
+      ::Smp::ViewKind::VK_None);
+  {
+    // Publish operation ResetProfile
+    receiver->PublishOperation(
+        "ResetProfile", "Reset the execution profile of the entry points.",
+        ::Smp::ViewKind::VK_None);
+  }
+  {
+    // Publish operation DumpProfile
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation(
+            "DumpProfile",
+            "Dump the execution profile of the entry points in a CSV file, or "
+            "in a JSON file if the file name ends with \".json\".",
+            ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "fileName", "", ::Smp::Uuids::Uuid_String8,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+  }
+  {
+    // Publish operation Lookahead
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation("Lookahead",
+                                   "Take a snapshot of the next simulation "
+                                   "time events, in execution order.",
+                                   ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "count", "", ::Smp::Uuids::Uuid_Int32,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+    operation->PublishParameter(
+        "return", "the number of events in the snapshot.",
+        ::Smp::Uuids::Uuid_Int32,
+        Smp::Publication::ParameterDirectionKind::PDK_Return);
+  }
+  {
+    // Publish operation GetLookaheadTime
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation("GetLookaheadTime",
+                                   "Get the simulation time of an event of "
+                                   "the last lookahead snapshot.",
+                                   ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "index", "", ::Smp::Uuids::Uuid_Int32,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+    operation->PublishParameter(
+        "return", "", ::Smp::Uuids::Uuid_Duration,
+        Smp::Publication::ParameterDirectionKind::PDK_Return);
+  }
+  {
+    // Publish operation GetLookaheadEventId
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation("GetLookaheadEventId",
+                                   "Get the identifier of an event of the "
+                                   "last lookahead snapshot.",
+                                   ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "index", "", ::Smp::Uuids::Uuid_Int32,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+    operation->PublishParameter(
+        "return", "", ::Smp::Uuids::Uuid_Int64,
+        Smp::Publication::ParameterDirectionKind::PDK_Return);
+  }
+  {
+    // Publish operation GetLookaheadEntryPoint
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation("GetLookaheadEntryPoint",
+                                   "Get the path of the entry point of an "
+                                   "event of the last lookahead snapshot.",
+                                   ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "index", "", ::Smp::Uuids::Uuid_Int32,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+    operation->PublishParameter(
+        "return", "", ::Smp::Uuids::Uuid_String8,
+        Smp::Publication::ParameterDirectionKind::PDK_Return);
+  }
+  {
+    // Publish operation RunToNextEvent
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation(
+            "RunToNextEvent",
+            "Run the simulation until all the events of the next scheduled "
+            "simulation time are executed, then hold it.",
+            ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "return", "the simulation time reached.", ::Smp::Uuids::Uuid_Duration,
+        Smp::Publication::ParameterDirectionKind::PDK_Return);
+  }
+  {
+    // Publish operation Step
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation("Step",
+                                   "Run the simulation for the given duration "
+                                   "on the calling thread, then hold it.",
+                                   ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "duration", "", ::Smp::Uuids::Uuid_Duration,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+    operation->PublishParameter(
+        "return", "the simulation time reached.", ::Smp::Uuids::Uuid_Duration,
+        Smp::Publication::ParameterDirectionKind::PDK_Return);
+  }
+  {
+    // Publish operation RunUntil
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation(
+            "RunUntil",
+            "Run the simulation until the given simulation time on the "
+            "calling thread, then hold it.",
+            ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "simulationTime", "", ::Smp::Uuids::Uuid_Duration,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+    operation->PublishParameter(
+        "return", "the simulation time reached.", ::Smp::Uuids::Uuid_Duration,
+        Smp::Publication::ParameterDirectionKind::PDK_Return);
+  }
+  {
+    // Publish operation StartTrace
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation(
+            "StartTrace",
+            "Start to record the executed events in a binary trace file.",
+            ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "fileName", "", ::Smp::Uuids::Uuid_String8,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+  }
+  {
+    // Publish operation StopTrace
+    receiver->PublishOperation(
+        "StopTrace",
+        "Stop to record the executed events and close the trace file.",
+        ::Smp::ViewKind::VK_None);
+  }
+  {
+    // Publish operation CompareTrace
+    ::Smp::Publication::IPublishOperation *operation =
+        receiver->PublishOperation(
+            "CompareTrace", "Compare a trace with a reference trace.",
+            ::Smp::ViewKind::VK_None);
+    operation->PublishParameter(
+        "referenceFileName", "", ::Smp::Uuids::Uuid_String8,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+    operation->PublishParameter(
+        "fileName", "", ::Smp::Uuids::Uuid_String8,
+        Smp::Publication::ParameterDirectionKind::PDK_In);
+    operation->PublishParameter(
+        "return",
+        "an empty string if the same events are executed in the same order "
+        "at the same simulation times, otherwise the description of the "
+        "first divergence.",
+        ::Smp::Uuids::Uuid_String8,
+        Smp::Publication::ParameterDirectionKind::PDK_Return);
+  }
   // Call user DoPublish if any
   ::Xsmp::Component::Helper::Publish<::Xsmp::Services::XsmpScheduler>(this,
                                                                       receiver);
@@ -81,6 +288,255 @@ void XsmpSchedulerGen::Disconnect() {
   ::Xsmp::Service::Disconnect();
 }
 
+XsmpSchedulerGen::RequestHandlers XsmpSchedulerGen::requestHandlers =
+    InitRequestHandlers();
+
+XsmpSchedulerGen::RequestHandlers XsmpSchedulerGen::InitRequestHandlers() {
+  RequestHandlers handlers;
+  if (handlers.find("get_FreeRunning") == handlers.end()) {
+    handlers["get_FreeRunning"] = [](XsmpSchedulerGen *component,
+                                     ::Smp::IRequest *request) {
+      /// Invoke get_FreeRunning
+      ::Xsmp::Request::setReturnValue(request,
+                                      ::Smp::PrimitiveTypeKind::PTK_Bool,
+                                      component->get_FreeRunning());
+    };
+  }
+  if (handlers.find("set_FreeRunning") == handlers.end()) {
+    handlers["set_FreeRunning"] = [](XsmpSchedulerGen *component,
+                                     ::Smp::IRequest *request) {
+      /// Invoke set_FreeRunning
+      component->set_FreeRunning(::Xsmp::Request::get<::Smp::Bool>(
+          component, request, "FreeRunning",
+          ::Smp::PrimitiveTypeKind::PTK_Bool));
+    };
+  }
+  if (handlers.find("get_Profiling") == handlers.end()) {
+    handlers["get_Profiling"] = [](XsmpSchedulerGen *component,
+                                   ::Smp::IRequest *request) {
+      /// Invoke get_Profiling
+      ::Xsmp::Request::setReturnValue(request,
+                                      ::Smp::PrimitiveTypeKind::PTK_Bool,
+                                      component->get_Profiling());
+    };
+  }
+  if (handlers.find("set_Profiling") == handlers.end()) {
+    handlers["set_Profiling"] = [](XsmpSchedulerGen *component,
+                                   ::Smp::IRequest *request) {
+      /// Invoke set_Profiling
+      component->set_Profiling(::Xsmp::Request::get<::Smp::Bool>(
+          component, request, "Profiling",
+          ::Smp::PrimitiveTypeKind::PTK_Bool));
+    };
+  }
+  if (handlers.find("get_Load") == handlers.end()) {
+    handlers["get_Load"] = [](XsmpSchedulerGen *component,
+                              ::Smp::IRequest *request) {
+      /// Invoke get_Load
+      ::Xsmp::Request::setReturnValue(request,
+                                      ::Smp::PrimitiveTypeKind::PTK_Float64,
+                                      component->get_Load());
+    };
+  }
+  if (handlers.find("get_Speed") == handlers.end()) {
+    handlers["get_Speed"] = [](XsmpSchedulerGen *component,
+                               ::Smp::IRequest *request) {
+      /// Invoke get_Speed
+      ::Xsmp::Request::setReturnValue(request,
+                                      ::Smp::PrimitiveTypeKind::PTK_Float64,
+                                      component->get_Speed());
+    };
+  }
+  if (handlers.find("get_OverrunPolicy") == handlers.end()) {
+    handlers["get_OverrunPolicy"] = [](XsmpSchedulerGen *component,
+                                       ::Smp::IRequest *request) {
+      /// Invoke get_OverrunPolicy
+      ::Xsmp::Request::setReturnValue(request,
+                                      ::Smp::PrimitiveTypeKind::PTK_Int32,
+                                      component->get_OverrunPolicy());
+    };
+  }
+  if (handlers.find("set_OverrunPolicy") == handlers.end()) {
+    handlers["set_OverrunPolicy"] = [](XsmpSchedulerGen *component,
+                                       ::Smp::IRequest *request) {
+      /// Invoke set_OverrunPolicy
+      component->set_OverrunPolicy(::Xsmp::Request::get<::Smp::Int32>(
+          component, request, "OverrunPolicy",
+          ::Smp::PrimitiveTypeKind::PTK_Int32));
+    };
+  }
+  if (handlers.find("get_OverrunTolerance") == handlers.end()) {
+    handlers["get_OverrunTolerance"] = [](XsmpSchedulerGen *component,
+                                          ::Smp::IRequest *request) {
+      /// Invoke get_OverrunTolerance
+      ::Xsmp::Request::setReturnValue(request,
+                                      ::Smp::PrimitiveTypeKind::PTK_Duration,
+                                      component->get_OverrunTolerance());
+    };
+  }
+  if (handlers.find("set_OverrunTolerance") == handlers.end()) {
+    handlers["set_OverrunTolerance"] = [](XsmpSchedulerGen *component,
+                                          ::Smp::IRequest *request) {
+      /// Invoke set_OverrunTolerance
+      component->set_OverrunTolerance(::Xsmp::Request::get<::Smp::Duration>(
+          component, request, "OverrunTolerance",
+          ::Smp::PrimitiveTypeKind::PTK_Duration));
+    };
+  }
+  if (handlers.find("get_OverrunCount") == handlers.end()) {
+    handlers["get_OverrunCount"] = [](XsmpSchedulerGen *component,
+                                      ::Smp::IRequest *request) {
+      /// Invoke get_OverrunCount
+      ::Xsmp::Request::setReturnValue(request,
+                                      ::Smp::PrimitiveTypeKind::PTK_Int64,
+                                      component->get_OverrunCount());
+    };
+  }
+  if (handlers.find("get_MaxLateness") == handlers.end()) {
+    handlers["get_MaxLateness"] = [](XsmpSchedulerGen *component,
+                                     ::Smp::IRequest *request) {
+      /// Invoke get_MaxLateness
+      ::Xsmp::Request::setReturnValue(request,
+                                      ::Smp::PrimitiveTypeKind::PTK_Duration,
+                                      component->get_MaxLateness());
+    };
+  }
+  if (handlers.find("ResetProfile") == handlers.end()) {
+    handlers["ResetProfile"] = [](XsmpSchedulerGen *cmp, ::Smp::IRequest *) {
+      /// Invoke ResetProfile
+      cmp->ResetProfile();
+    };
+  }
+  if (handlers.find("DumpProfile") == handlers.end()) {
+    handlers["DumpProfile"] = [](XsmpSchedulerGen *cmp,
+                                 ::Smp::IRequest *req) {
+      /// Invoke DumpProfile
+      cmp->DumpProfile(::Xsmp::Request::get<::Smp::String8>(
+          cmp, req, "fileName", ::Smp::PrimitiveTypeKind::PTK_String8));
+    };
+  }
+  if (handlers.find("Lookahead") == handlers.end()) {
+    handlers["Lookahead"] = [](XsmpSchedulerGen *cmp, ::Smp::IRequest *req) {
+      /// Invoke Lookahead
+      const auto p_return = cmp->Lookahead(::Xsmp::Request::get<::Smp::Int32>(
+          cmp, req, "count", ::Smp::PrimitiveTypeKind::PTK_Int32));
+
+      ::Xsmp::Request::setReturnValue(req, ::Smp::PrimitiveTypeKind::PTK_Int32,
+                                      p_return);
+    };
+  }
+  if (handlers.find("GetLookaheadTime") == handlers.end()) {
+    handlers["GetLookaheadTime"] = [](XsmpSchedulerGen *cmp,
+                                      ::Smp::IRequest *req) {
+      /// Invoke GetLookaheadTime
+      const auto p_return =
+          cmp->GetLookaheadTime(::Xsmp::Request::get<::Smp::Int32>(
+              cmp, req, "index", ::Smp::PrimitiveTypeKind::PTK_Int32));
+
+      ::Xsmp::Request::setReturnValue(
+          req, ::Smp::PrimitiveTypeKind::PTK_Duration, p_return);
+    };
+  }
+  if (handlers.find("GetLookaheadEventId") == handlers.end()) {
+    handlers["GetLookaheadEventId"] = [](XsmpSchedulerGen *cmp,
+                                         ::Smp::IRequest *req) {
+      /// Invoke GetLookaheadEventId
+      const auto p_return =
+          cmp->GetLookaheadEventId(::Xsmp::Request::get<::Smp::Int32>(
+              cmp, req, "index", ::Smp::PrimitiveTypeKind::PTK_Int32));
+
+      ::Xsmp::Request::setReturnValue(req, ::Smp::PrimitiveTypeKind::PTK_Int64,
+                                      p_return);
+    };
+  }
+  if (handlers.find("GetLookaheadEntryPoint") == handlers.end()) {
+    handlers["GetLookaheadEntryPoint"] = [](XsmpSchedulerGen *cmp,
+                                            ::Smp::IRequest *req) {
+      /// Invoke GetLookaheadEntryPoint
+      const auto p_return =
+          cmp->GetLookaheadEntryPoint(::Xsmp::Request::get<::Smp::Int32>(
+              cmp, req, "index", ::Smp::PrimitiveTypeKind::PTK_Int32));
+
+      ::Xsmp::Request::setReturnValue(
+          req, ::Smp::PrimitiveTypeKind::PTK_String8, p_return);
+    };
+  }
+  if (handlers.find("RunToNextEvent") == handlers.end()) {
+    handlers["RunToNextEvent"] = [](XsmpSchedulerGen *cmp,
+                                    ::Smp::IRequest *req) {
+      /// Invoke RunToNextEvent
+      const auto p_return = cmp->RunToNextEvent();
+
+      ::Xsmp::Request::setReturnValue(
+          req, ::Smp::PrimitiveTypeKind::PTK_Duration, p_return);
+    };
+  }
+  if (handlers.find("Step") == handlers.end()) {
+    handlers["Step"] = [](XsmpSchedulerGen *cmp, ::Smp::IRequest *req) {
+      /// Invoke Step
+      const auto p_return = cmp->Step(::Xsmp::Request::get<::Smp::Duration>(
+          cmp, req, "duration", ::Smp::PrimitiveTypeKind::PTK_Duration));
+
+      ::Xsmp::Request::setReturnValue(
+          req, ::Smp::PrimitiveTypeKind::PTK_Duration, p_return);
+    };
+  }
+  if (handlers.find("RunUntil") == handlers.end()) {
+    handlers["RunUntil"] = [](XsmpSchedulerGen *cmp, ::Smp::IRequest *req) {
+      /// Invoke RunUntil
+      const auto p_return =
+          cmp->RunUntil(::Xsmp::Request::get<::Smp::Duration>(
+              cmp, req, "simulationTime",
+              ::Smp::PrimitiveTypeKind::PTK_Duration));
+
+      ::Xsmp::Request::setReturnValue(
+          req, ::Smp::PrimitiveTypeKind::PTK_Duration, p_return);
+    };
+  }
+  if (handlers.find("StartTrace") == handlers.end()) {
+    handlers["StartTrace"] = [](XsmpSchedulerGen *cmp, ::Smp::IRequest *req) {
+      /// Invoke StartTrace
+      cmp->StartTrace(::Xsmp::Request::get<::Smp::String8>(
+          cmp, req, "fileName", ::Smp::PrimitiveTypeKind::PTK_String8));
+    };
+  }
+  if (handlers.find("StopTrace") == handlers.end()) {
+    handlers["StopTrace"] = [](XsmpSchedulerGen *cmp, ::Smp::IRequest *) {
+      /// Invoke StopTrace
+      cmp->StopTrace();
+    };
+  }
+  if (handlers.find("CompareTrace") == handlers.end()) {
+    handlers["CompareTrace"] = [](XsmpSchedulerGen *cmp,
+                                  ::Smp::IRequest *req) {
+      /// Invoke CompareTrace
+      const auto p_return = cmp->CompareTrace(
+          ::Xsmp::Request::get<::Smp::String8>(
+              cmp, req, "referenceFileName",
+              ::Smp::PrimitiveTypeKind::PTK_String8),
+          ::Xsmp::Request::get<::Smp::String8>(
+              cmp, req, "fileName", ::Smp::PrimitiveTypeKind::PTK_String8));
+
+      ::Xsmp::Request::setReturnValue(
+          req, ::Smp::PrimitiveTypeKind::PTK_String8, p_return);
+    };
+  }
+  return handlers;
+}
+
+void XsmpSchedulerGen::Invoke(::Smp::IRequest *request) {
+  if (request == nullptr) {
+    return;
+  }
+  auto handler = requestHandlers.find(request->GetOperationName());
+  if (handler != requestHandlers.end()) {
+    handler->second(this, request);
+  } else {
+    // pass the request down to the base model
+    ::Xsmp::Service::Invoke(request);
+  }
+}
+
 const Smp::Uuid &XsmpSchedulerGen::GetUuid() const {
   return Uuid_XsmpScheduler;
 }
@@ -26,12 +26,17 @@
 // ----------------------------------------------------------------------------
 
 #include <Smp/IPersist.h>
+#include <Smp/IRequest.h>
 #include <Smp/ISimulator.h>
+#include <Smp/PrimitiveTypes.h>
+#include <Smp/Publication/IPublishOperation.h>
 #include <Smp/Publication/ITypeRegistry.h>
 #include <Smp/Services/IScheduler.h>
 #include <Xsmp/EntryPoint.h>
 #include <Xsmp/EntryPointPublisher.h>
 #include <Xsmp/Service.h>
+#include <functional>
+#include <map>
 #include <type_traits>
 
 // ----------------------------------------------------------------------------
@@ -106,12 +111,130 @@ public:
   /// @return Universally Unique Identifier of the Model.
   const Smp::Uuid &GetUuid() const override;
 
+  // ----------------------------------------------------------------------------------
+  // --------------------------- IDynamicInvocation ---------------------------
+  // ----------------------------------------------------------------------------------
+  using RequestHandlers = std::map<
+      std::string, std::function<void(XsmpSchedulerGen *, ::Smp::IRequest *)>>;
+  static RequestHandlers requestHandlers;
+  static RequestHandlers InitRequestHandlers();
+
+  /// Invoke the operation for the given request.
+  /// @param request Request object to invoke.
+  void Invoke(::Smp::IRequest *request) override;
+
+  /// Reset the execution profile of the entry points.
+  virtual void ResetProfile() = 0;
+  /// Dump the execution profile of the entry points in a CSV file, or in a
+  /// JSON file if the file name ends with ".json".
+  /// @param fileName
+  virtual void DumpProfile(::Smp::String8 fileName) = 0;
+  /// Take a snapshot of the next simulation time events, in execution order.
+  /// @param count
+  /// @return the number of events in the snapshot.
+  virtual ::Smp::Int32 Lookahead(::Smp::Int32 count) = 0;
+  /// Get the simulation time of an event of the last lookahead snapshot.
+  /// @param index
+  virtual ::Smp::Duration GetLookaheadTime(::Smp::Int32 index) = 0;
+  /// Get the identifier of an event of the last lookahead snapshot.
+  /// @param index
+  virtual ::Smp::Int64 GetLookaheadEventId(::Smp::Int32 index) = 0;
+  /// Get the path of the entry point of an event of the last lookahead
+  /// snapshot.
+  /// The string is valid until the next call by the same thread.
+  /// @param index
+  virtual ::Smp::String8 GetLookaheadEntryPoint(::Smp::Int32 index) = 0;
+  /// Run the simulation until all the events of the next scheduled simulation
+  /// time are executed, then hold it.
+  /// @return the simulation time reached.
+  virtual ::Smp::Duration RunToNextEvent() = 0;
+  /// Run the simulation for the given duration on the calling thread, then
+  /// hold it.
+  /// @param duration
+  /// @return the simulation time reached.
+  virtual ::Smp::Duration Step(::Smp::Duration duration) = 0;
+  /// Run the simulation until the given simulation time on the calling thread,
+  /// then hold it.
+  /// @param simulationTime
+  /// @return the simulation time reached.
+  virtual ::Smp::Duration RunUntil(::Smp::Duration simulationTime) = 0;
+  /// Start to record the executed events in a binary trace file.
+  /// @param fileName
+  virtual void StartTrace(::Smp::String8 fileName) = 0;
+  /// Stop to record the executed events and close the trace file.
+  virtual void StopTrace() = 0;
+  /// Compare a trace with a reference trace.
+  /// @param referenceFileName
+  /// @param fileName
+  /// @return an empty string if the same events are executed in the same
+  /// order at the same simulation times, otherwise the description of the
+  /// first divergence.
+  virtual ::Smp::String8 CompareTrace(::Smp::String8 referenceFileName,
+                                      ::Smp::String8 fileName) = 0;
+
   ::Xsmp::EntryPoint HoldEvent;
   virtual void _HoldEvent() = 0;
   ::Xsmp::EntryPoint EnterExecuting;
   virtual void _EnterExecuting() = 0;
   ::Xsmp::EntryPoint LeaveExecuting;
   virtual void _LeaveExecuting() = 0;
+
+private:
+  /// Get FreeRunning.
+  /// Execute the events as fast as possible, without synchronization with the
+  /// Zulu time.
+  /// @return Current value of property FreeRunning.
+  virtual ::Smp::Bool get_FreeRunning() = 0;
+  /// Set FreeRunning.
+  /// Execute the events as fast as possible, without synchronization with the
+  /// Zulu time.
+  /// @param value New value of property FreeRunning to set.
+  virtual void set_FreeRunning(::Smp::Bool value) = 0;
+  /// Get Profiling.
+  /// Record the execution time of the entry points executed by the scheduler.
+  /// @return Current value of property Profiling.
+  virtual ::Smp::Bool get_Profiling() = 0;
+  /// Set Profiling.
+  /// Record the execution time of the entry points executed by the scheduler.
+  /// @param value New value of property Profiling to set.
+  virtual void set_Profiling(::Smp::Bool value) = 0;
+  /// Get Load.
+  /// Average part of the real time budget used to execute the events.
+  /// @return Current value of property Load.
+  virtual ::Smp::Float64 get_Load() = 0;
+  /// Get Speed.
+  /// Average ratio between the elapsed simulation time and the elapsed Zulu
+  /// time.
+  /// @return Current value of property Speed.
+  virtual ::Smp::Float64 get_Speed() = 0;
+  /// Get OverrunPolicy.
+  /// Policy applied when a time step misses its Zulu deadline: 0 to catch up
+  /// the lost time, 1 to skip to the current Zulu time, 2 to hold the
+  /// simulation, 3 to emit the XSMP_SchedulerOverrun event.
+  /// @return Current value of property OverrunPolicy.
+  virtual ::Smp::Int32 get_OverrunPolicy() = 0;
+  /// Set OverrunPolicy.
+  /// Policy applied when a time step misses its Zulu deadline: 0 to catch up
+  /// the lost time, 1 to skip to the current Zulu time, 2 to hold the
+  /// simulation, 3 to emit the XSMP_SchedulerOverrun event.
+  /// @param value New value of property OverrunPolicy to set.
+  virtual void set_OverrunPolicy(::Smp::Int32 value) = 0;
+  /// Get OverrunTolerance.
+  /// Lateness on the Zulu deadline below which a time step is not an overrun.
+  /// @return Current value of property OverrunTolerance.
+  virtual ::Smp::Duration get_OverrunTolerance() = 0;
+  /// Set OverrunTolerance.
+  /// Lateness on the Zulu deadline below which a time step is not an overrun.
+  /// @param value New value of property OverrunTolerance to set.
+  virtual void set_OverrunTolerance(::Smp::Duration value) = 0;
+  /// Get OverrunCount.
+  /// Number of time steps that missed their Zulu deadline.
+  /// @return Current value of property OverrunCount.
+  virtual ::Smp::Int64 get_OverrunCount() = 0;
+  /// Get MaxLateness.
+  /// Worst lateness of a time step on its Zulu deadline.
+  /// @return Current value of property MaxLateness.
+  virtual ::Smp::Duration get_MaxLateness() = 0;
 };
 } // namespace Xsmp::Services
 
@@ -37,6 +37,9 @@ Component::Component(::Smp::String8 name, ::Smp::String8 description,
                      ::Smp::IComposite *parent, ::Smp::ISimulator *simulator)
     : _name(::Xsmp::Helper::checkName(name, parent)), _description(description),
       _parent(parent), _simulator{simulator} {}
+
+Component::~Component() noexcept { ::Xsmp::Helper::ForgetPath(this); }
+
 ::Smp::String8 Component::GetName() const { return _name.c_str(); }
 
 ::Smp::String8 Component::GetDescription() const {
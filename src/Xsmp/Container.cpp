@@ -78,6 +78,10 @@ AbstractContainer::AbstractContainer(::Smp::String8 name,
                                      ::Smp::Int64 upper)
     : _name(::Xsmp::Helper::checkName(name, parent)), _description(description),
       _parent(parent), _collection(*this), _lower(lower), _upper(upper) {}
+
+AbstractContainer::~AbstractContainer() noexcept {
+  ::Xsmp::Helper::ForgetPath(this);
+}
 ::Smp::String8 AbstractContainer::GetName() const { return _name.c_str(); }
 
 ::Smp::String8 AbstractContainer::GetDescription() const {
@@ -35,6 +35,8 @@ EntryPoint::EntryPoint(::Smp::String8 name, ::Smp::String8 description,
     : _name(::Xsmp::Helper::checkName(name, parent)), _description(description),
       _parent(parent), _callback{std::move(callback)} {}
 
+EntryPoint::~EntryPoint() noexcept { ::Xsmp::Helper::ForgetPath(this); }
+
 ::Smp::String8 EntryPoint::GetName() const { return _name.c_str(); }
 
 ::Smp::String8 EntryPoint::GetDescription() const {
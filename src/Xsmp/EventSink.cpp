@@ -34,6 +34,11 @@ AbstractEventSink::AbstractEventSink(::Smp::String8 name,
                                      ::Smp::IObject *parent)
     : _name(::Xsmp::Helper::checkName(name, parent)), _description(description),
       _parent(parent) {}
+
+AbstractEventSink::~AbstractEventSink() noexcept {
+  ::Xsmp::Helper::ForgetPath(this);
+}
+
 ::Smp::String8 AbstractEventSink::GetName() const { return _name.c_str(); }
 
 ::Smp::String8 AbstractEventSink::GetDescription() const {
@@ -36,6 +36,10 @@ AbstractEventSource::AbstractEventSource(::Smp::String8 name,
                                          ::Smp::PrimitiveTypeKind eventArgType)
     : _name(::Xsmp::Helper::checkName(name, parent)), _description(description),
       _parent(parent), _eventArgType{eventArgType} {}
+
+AbstractEventSource::~AbstractEventSource() noexcept {
+  ::Xsmp::Helper::ForgetPath(this);
+}
 ::Smp::String8 AbstractEventSource::GetName() const { return _name.c_str(); }
 
 ::Smp::String8 AbstractEventSource::GetDescription() const {
@@ -1362,7 +1362,7 @@ private:
 
 namespace detail {
 std::ostream &operator<<(std::ostream &ostream, const ::Smp::IObject *obj) {
-  return ostream << ::Xsmp::Helper::GetPath(obj);
+  return ostream << ::Xsmp::Helper::GetCachedPath(obj);
 }
 void throwException(const ::Smp::IObject *sender, std::string_view name,
                     std::string_view description, std::string_view message) {
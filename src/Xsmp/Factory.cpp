@@ -31,6 +31,8 @@ Factory::Factory(::Smp::String8 name, ::Smp::String8 description,
       _callback{std::move(callback)},
       _typeName(Xsmp::Helper::demangle(type.name()).c_str()) {}
 
+Factory::~Factory() noexcept { ::Xsmp::Helper::ForgetPath(this); }
+
 ::Smp::String8 Factory::GetName() const { return _name.c_str(); }
 ::Smp::String8 Factory::GetDescription() const { return _description.c_str(); }
 ::Smp::IObject *Factory::GetParent() const { return _simulator; }
@@ -323,6 +323,8 @@ AbstractField::AbstractField(::Smp::String8 name, ::Smp::String8 description,
     structure->AddField(*this);
   }
 }
+
+AbstractField::~AbstractField() noexcept { ::Xsmp::Helper::ForgetPath(this); }
 ::Smp::String8 AbstractField::GetName() const { return _name.c_str(); }
 
 ::Smp::String8 AbstractField::GetDescription() const {
@@ -33,6 +33,7 @@
 #include <Smp/IStructureField.h>
 #include <Smp/PrimitiveTypes.h>
 #include <Smp/Publication/IType.h>
+#include <Smp/Services/IEventManager.h>
 #include <Smp/Services/ILogger.h>
 #include <Xsmp/Exception.h>
 #include <Xsmp/Helper.h>
@@ -43,8 +44,12 @@
 #include <cstdlib>
 #include <exception>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
 
 #if defined(__GNUG__)
 #include <cxxabi.h>
@@ -52,46 +57,111 @@
 
 namespace Xsmp::Helper {
 
+bool IsLogEnabled(const ::Smp::Services::ILogger *logger,
+                  const ::Smp::IObject *sender,
+                  ::Smp::Services::LogMessageKind kind) noexcept {
+  if (!logger) {
+    return false;
+  }
+  // the cross cast is cached per thread: the filter offset only depends on
+  // the dynamic type, that is checked to detect a reused address
+  thread_local const ::Smp::Services::ILogger *cachedLogger = nullptr;
+  thread_local const std::type_info *cachedType = nullptr;
+  thread_local const ::Xsmp::ILogFilter *cachedFilter = nullptr;
+
+  const auto &type = typeid(*logger);
+  if (logger != cachedLogger || type != *cachedType) {
+    cachedLogger = logger;
+    cachedType = &type;
+    cachedFilter = dynamic_cast<const ::Xsmp::ILogFilter *>(logger);
+  }
+  return !cachedFilter || cachedFilter->IsLogEnabled(sender, kind);
+}
+
+void FlushEvents(::Smp::Services::IEventManager *eventManager) {
+  if (auto *dispatcher =
+          dynamic_cast<::Xsmp::IEventDispatcher *>(eventManager)) {
+    dispatcher->Flush();
+  }
+}
+
+void Subscribe(::Smp::Services::IEventManager *eventManager,
+               ::Smp::Services::EventId event,
+               const ::Smp::IEntryPoint *entryPoint, ::Smp::Int32 priority) {
+  if (auto *dispatcher =
+          dynamic_cast<::Xsmp::IEventDispatcher *>(eventManager)) {
+    dispatcher->Subscribe(event, entryPoint, priority);
+  } else {
+    eventManager->Subscribe(event, entryPoint);
+  }
+}
+
 void SafeExecute(::Smp::ISimulator *simulator,
                  const ::Smp::IEntryPoint *entryPoint) {
+  SafeExecute(simulator, &entryPoint, 1);
+}
+
+void SafeExecute(::Smp::ISimulator *simulator,
+                 const ::Smp::IEntryPoint *const *entryPoints,
+                 std::size_t count) {
 
-  if (simulator) {
+  if (!simulator) {
+    for (std::size_t index = 0; index < count; ++index) {
+      entryPoints[index]->Execute();
+    }
+    return;
+  }
+  auto *logger = simulator->GetLogger();
+  std::size_t index = 0;
+  while (index < count) {
+    // the guard is only re-entered after a failing entry point
     try {
-      simulator->GetLogger()->Log(entryPoint, "Execute()",
-                                  ::Smp::Services::ILogger::LMK_Debug);
+      for (; index < count; ++index) {
+        const auto *entryPoint = entryPoints[index];
+        // the filter may depend on the sender
+        const bool debug = IsLogEnabled(logger, entryPoint,
+                                        ::Smp::Services::ILogger::LMK_Debug);
+        if (debug) {
+          logger->Log(entryPoint, "Execute()",
+                      ::Smp::Services::ILogger::LMK_Debug);
+        }
 
-      entryPoint->Execute();
+        entryPoint->Execute();
 
-      simulator->GetLogger()->Log(entryPoint, "return from Execute()",
-                                  ::Smp::Services::ILogger::LMK_Debug);
+        if (debug) {
+          logger->Log(entryPoint, "return from Execute()",
+                      ::Smp::Services::ILogger::LMK_Debug);
+        }
+      }
     }
     // SMP Exception
     catch (const ::Smp::Exception &e) {
       auto msg =
           std::string("Exception ") + e.GetName() + " thrown during execution.";
-      simulator->GetLogger()->Log(entryPoint, msg.c_str(),
+      simulator->GetLogger()->Log(entryPoints[index], msg.c_str(),
                                   ::Smp::Services::ILogger::LMK_Error);
       simulator->GetLogger()->Log(e.GetSender(), e.what(),
                                   ::Smp::Services::ILogger::LMK_Error);
       simulator->Abort();
+      ++index;
     }
     // standard c++ exception
     catch (const std::exception &e) {
 
       auto msg = std::string("Exception thrown during execution: ") + e.what();
-      simulator->GetLogger()->Log(entryPoint, msg.c_str(),
+      simulator->GetLogger()->Log(entryPoints[index], msg.c_str(),
                                   ::Smp::Services::ILogger::LMK_Error);
       simulator->Abort();
+      ++index;
     }
     // other exceptions
     catch (...) {
       simulator->GetLogger()->Log(
-          entryPoint, "Unexpected exception thrown during execution.",
+          entryPoints[index], "Unexpected exception thrown during execution.",
           ::Smp::Services::ILogger::LMK_Error);
       simulator->Abort();
+      ++index;
     }
-  } else {
-    entryPoint->Execute();
   }
 }
 namespace {
@@ -291,31 +361,144 @@ inline bool AreEquivalent(const ::Smp::IStructureField *source,
 
 } // namespace
 
-std::string GetPath(const ::Smp::IObject *obj) {
+namespace {
+/// @return the separator between the path of the parent of an object and its
+/// name
+std::string_view GetPathSeparator(const ::Smp::IObject *obj,
+                                  const ::Smp::IObject *parent) {
+  if (dynamic_cast<const ::Smp::ISimulator *>(parent)) {
+    return "";
+  }
+  // use '/' separator between components
+  if (dynamic_cast<const ::Smp::IComponent *>(obj)) {
+    return "/";
+  }
+  // no separator for array items
+  if (dynamic_cast<const ::Smp::IArrayField *>(parent)) {
+    return "";
+  }
+  // use '.' separator between all others elements : fields, entry points,
+  // event sink/sources, ...
+  return ".";
+}
 
+void AppendPath(std::string &path, const ::Smp::IObject *obj) {
   if (!obj) {
-    return "<null>";
+    path.append("<null>");
+    return;
   }
   if (dynamic_cast<const ::Smp::ISimulator *>(obj)) {
-    return "/";
+    path.append("/");
+    return;
   }
   auto *parent = obj->GetParent();
+  AppendPath(path, parent);
+  path.append(GetPathSeparator(obj, parent)).append(obj->GetName());
+}
+
+struct CachedPath {
+  /// the parent and name used to compute the path: an object at the address
+  /// of a deleted one that is not evicted is detected if they differ
+  const ::Smp::IObject *parent;
+  ::Smp::String8 name;
+  std::string path;
+};
+
+/// The path cache of a thread.
+/// The other threads only lock it to evict the paths of deleted objects.
+struct PathCache {
+  PathCache();
+  PathCache(const PathCache &) = delete;
+  PathCache &operator=(const PathCache &) = delete;
+  ~PathCache();
+
+  std::mutex mutex;
+  std::unordered_map<const ::Smp::IObject *, CachedPath> paths;
+};
+
+/// The path caches of all the threads
+struct PathCaches {
+  std::mutex mutex;
+  std::vector<PathCache *> caches;
+};
+
+PathCaches &GetPathCaches() {
+  // never deleted: the caches of the threads may outlive the static objects
+  static auto *caches = new PathCaches;
+  return *caches;
+}
 
-  if (dynamic_cast<::Smp::ISimulator *>(parent)) {
-    return GetPath(parent) + obj->GetName();
+PathCache::PathCache() {
+  auto &caches = GetPathCaches();
+  const std::scoped_lock lck{caches.mutex};
+  caches.caches.push_back(this);
+}
+
+PathCache::~PathCache() {
+  auto &caches = GetPathCaches();
+  const std::scoped_lock lck{caches.mutex};
+  caches.caches.erase(
+      std::find(caches.caches.begin(), caches.caches.end(), this));
+}
+
+/// Get a cached path (the mutex of the cache must be locked)
+const std::string &GetCachedPath(PathCache &cache, const ::Smp::IObject *obj) {
+  static const std::string nullPath{"<null>"};
+  if (!obj) {
+    return nullPath;
   }
-  // use '/' separator between components
-  if (dynamic_cast<const ::Smp::IComponent *>(obj)) {
-    return GetPath(parent) + "/" + obj->GetName();
+  auto *parent = obj->GetParent();
+  const auto *name = obj->GetName();
+  // the references to the elements are not invalidated by a rehash
+  auto &cached = cache.paths[obj];
+  if (!cached.path.empty() && cached.parent == parent && cached.name == name) {
+    return cached.path;
   }
-  // no separator for array items
-  if (dynamic_cast<const ::Smp::IArrayField *>(parent)) {
-    return GetPath(parent) + obj->GetName();
+  cached.parent = parent;
+  cached.name = name;
+
+  if (dynamic_cast<const ::Smp::ISimulator *>(obj)) {
+    cached.path = "/";
+    return cached.path;
+  }
+  const auto &parentPath = GetCachedPath(cache, parent);
+  const std::string_view nameView{name};
+  const auto separator = GetPathSeparator(obj, parent);
+  cached.path.clear();
+  cached.path.reserve(parentPath.size() + separator.size() + nameView.size());
+  cached.path.append(parentPath).append(separator).append(nameView);
+  return cached.path;
+}
+
+/// Apply an action on the caches of all the threads
+template <typename Action> void ForEachPathCache(Action &&action) noexcept {
+  auto &caches = GetPathCaches();
+  const std::scoped_lock lck{caches.mutex};
+  for (auto *cache : caches.caches) {
+    const std::scoped_lock cacheLck{cache->mutex};
+    action(*cache);
   }
+}
+} // namespace
 
-  // use '.' separator between all others elements : fields, entry points, event
-  // sink/sources, ...
-  return GetPath(parent) + "." + obj->GetName();
+const std::string &GetCachedPath(const ::Smp::IObject *obj) {
+  thread_local PathCache cache;
+  const std::scoped_lock lck{cache.mutex};
+  return GetCachedPath(cache, obj);
+}
+
+void ForgetPath(const ::Smp::IObject *obj) noexcept {
+  ForEachPathCache([obj](PathCache &cache) { cache.paths.erase(obj); });
+}
+
+void InvalidatePaths() noexcept {
+  ForEachPathCache([](PathCache &cache) { cache.paths.clear(); });
+}
+
+std::string GetPath(const ::Smp::IObject *obj) {
+  std::string path;
+  AppendPath(path, obj);
+  return path;
 }
 
 ::Smp::IObject *Resolve(const ::Smp::FieldCollection *fields,
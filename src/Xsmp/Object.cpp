@@ -24,6 +24,8 @@ Object::Object(::Smp::String8 name, ::Smp::String8 description,
     : _name(::Xsmp::Helper::checkName(name, parent)), _description(description),
       _parent(parent) {}
 
+Object::~Object() noexcept { ::Xsmp::Helper::ForgetPath(this); }
+
 ::Smp::String8 Object::GetName() const { return _name.c_str(); }
 
 ::Smp::String8 Object::GetDescription() const { return _description.c_str(); }
@@ -75,6 +75,8 @@ Field::Field(::Smp::String8 name, ::Smp::String8 description,
       _parent(parent), _address(nullptr), _type(nullptr), _view(view),
       _state(state), _input(false), _output(false) {}
 
+Field::~Field() noexcept { ::Xsmp::Helper::ForgetPath(this); }
+
 ::Smp::String8 Field::GetName() const { return _name.c_str(); }
 ::Smp::String8 Field::GetDescription() const { return _description.c_str(); }
 ::Smp::IObject *Field::GetParent() const { return _parent; }
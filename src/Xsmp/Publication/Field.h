@@ -54,6 +54,7 @@ public:
         ::Smp::Bool output);
   Field(::Smp::String8 name, ::Smp::String8 description, ::Smp::IObject *parent,
         ::Smp::ViewKind view, ::Smp::Bool state);
+  ~Field() noexcept override;
   /// Field cannot be copied
   Field(const Field &) = delete;
   /// Field cannot be copied
@@ -62,6 +62,8 @@ Operation::Operation(::Smp::String8 name, ::Smp::String8 description,
     : _name(::Xsmp::Helper::checkName(name, parent)), _description(description),
       _parent(parent), _parameters{"Parameters", "", parent},
       _typeRegistry{typeRegistry}, _view(view) {}
+
+Operation::~Operation() noexcept { ::Xsmp::Helper::ForgetPath(this); }
 ::Smp::String8 Operation::GetName() const { return _name.c_str(); }
 
 ::Smp::String8 Operation::GetDescription() const {
@@ -39,7 +39,7 @@ public:
             ::Smp::IObject *parent = nullptr,
             ::Smp::ViewKind view = ::Smp::ViewKind::VK_None,
             ::Smp::Publication::ITypeRegistry *typeRegistry = nullptr);
-  ~Operation() noexcept override = default;
+  ~Operation() noexcept override;
   /// Operation cannot be copied
   Operation(const Operation &) = delete;
   /// Operation cannot be copied
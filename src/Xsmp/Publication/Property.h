@@ -39,6 +39,7 @@ public:
            ::Smp::IObject *parent, ::Smp::Publication::IType *type,
            ::Smp::AccessKind accessKind = ::Smp::AccessKind::AK_ReadWrite,
            ::Smp::ViewKind view = ::Smp::ViewKind::VK_None);
+  ~Property() noexcept override;
   /// Property cannot be copied
   Property(const Property &) = delete;
   /// Property cannot be copied
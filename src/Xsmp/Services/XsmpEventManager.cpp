@@ -30,12 +30,41 @@
 #include <Xsmp/Services/XsmpEventManager.h>
 #include <Xsmp/Services/XsmpEventManagerGen.h>
 #include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace Xsmp::Services {
 
+namespace {
+// whether the current thread executes asynchronous emissions
+thread_local bool isDispatchThread = false;
+
+// count an emission in progress
+class EmittingScope {
+public:
+  explicit EmittingScope(std::atomic<std::size_t> &counter)
+      : _counter{counter} {
+    _counter.fetch_add(1);
+  }
+  EmittingScope(const EmittingScope &) = delete;
+  EmittingScope &operator=(const EmittingScope &) = delete;
+  ~EmittingScope() { _counter.fetch_sub(1); }
+
+private:
+  std::atomic<std::size_t> &_counter;
+};
+} // namespace
+
 using namespace ::Smp::Services;
 XsmpEventManager::XsmpEventManager(::Smp::String8 name,
                                    ::Smp::String8 description,
@@ -44,49 +73,124 @@ XsmpEventManager::XsmpEventManager(::Smp::String8 name,
     : XsmpEventManagerGen::XsmpEventManagerGen(name, description, parent,
                                                simulator) {
 
-  auto eventsAccess = _events.write();
-  eventsAccess.get().try_emplace(IEventManager::SMP_LeaveConnecting,
-                                 IEventManager::SMP_LeaveConnectingId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_EnterInitialising,
-                                 IEventManager::SMP_EnterInitialisingId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_LeaveInitialising,
-                                 IEventManager::SMP_LeaveInitialisingId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_EnterStandby,
-                                 IEventManager::SMP_EnterStandbyId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_LeaveStandby,
-                                 IEventManager::SMP_LeaveStandbyId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_EnterExecuting,
-                                 IEventManager::SMP_EnterExecutingId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_LeaveExecuting,
-                                 IEventManager::SMP_LeaveExecutingId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_EnterStoring,
-                                 IEventManager::SMP_EnterStoringId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_LeaveStoring,
-                                 IEventManager::SMP_LeaveStoringId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_EnterRestoring,
-                                 IEventManager::SMP_EnterRestoringId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_LeaveRestoring,
-                                 IEventManager::SMP_LeaveRestoringId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_EnterExiting,
-                                 IEventManager::SMP_EnterExitingId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_EnterAborting,
-                                 IEventManager::SMP_EnterAbortingId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_EpochTimeChanged,
-                                 IEventManager::SMP_EpochTimeChangedId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_MissionTimeChanged,
-                                 IEventManager::SMP_MissionTimeChangedId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_EnterReconnecting,
-                                 IEventManager::SMP_EnterReconnectingId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_LeaveReconnecting,
-                                 IEventManager::SMP_LeaveReconnectingId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_PreSimTimeChange,
-                                 IEventManager::SMP_PreSimTimeChangeId);
-  eventsAccess.get().try_emplace(IEventManager::SMP_PostSimTimeChange,
-                                 IEventManager::SMP_PostSimTimeChangeId);
-
-  auto idsAccess = _ids.write();
-  for (const auto &[eventName, id] : eventsAccess.get()) {
-    idsAccess.get().try_emplace(id, eventName);
+  const std::scoped_lock lck{_mutex};
+  RegisterEvent(IEventManager::SMP_LeaveConnecting,
+                IEventManager::SMP_LeaveConnectingId);
+  RegisterEvent(IEventManager::SMP_EnterInitialising,
+                IEventManager::SMP_EnterInitialisingId);
+  RegisterEvent(IEventManager::SMP_LeaveInitialising,
+                IEventManager::SMP_LeaveInitialisingId);
+  RegisterEvent(IEventManager::SMP_EnterStandby,
+                IEventManager::SMP_EnterStandbyId);
+  RegisterEvent(IEventManager::SMP_LeaveStandby,
+                IEventManager::SMP_LeaveStandbyId);
+  RegisterEvent(IEventManager::SMP_EnterExecuting,
+                IEventManager::SMP_EnterExecutingId);
+  RegisterEvent(IEventManager::SMP_LeaveExecuting,
+                IEventManager::SMP_LeaveExecutingId);
+  RegisterEvent(IEventManager::SMP_EnterStoring,
+                IEventManager::SMP_EnterStoringId);
+  RegisterEvent(IEventManager::SMP_LeaveStoring,
+                IEventManager::SMP_LeaveStoringId);
+  RegisterEvent(IEventManager::SMP_EnterRestoring,
+                IEventManager::SMP_EnterRestoringId);
+  RegisterEvent(IEventManager::SMP_LeaveRestoring,
+                IEventManager::SMP_LeaveRestoringId);
+  RegisterEvent(IEventManager::SMP_EnterExiting,
+                IEventManager::SMP_EnterExitingId);
+  RegisterEvent(IEventManager::SMP_EnterAborting,
+                IEventManager::SMP_EnterAbortingId);
+  RegisterEvent(IEventManager::SMP_EpochTimeChanged,
+                IEventManager::SMP_EpochTimeChangedId);
+  RegisterEvent(IEventManager::SMP_MissionTimeChanged,
+                IEventManager::SMP_MissionTimeChangedId);
+  RegisterEvent(IEventManager::SMP_EnterReconnecting,
+                IEventManager::SMP_EnterReconnectingId);
+  RegisterEvent(IEventManager::SMP_LeaveReconnecting,
+                IEventManager::SMP_LeaveReconnectingId);
+  RegisterEvent(IEventManager::SMP_PreSimTimeChange,
+                IEventManager::SMP_PreSimTimeChangeId);
+  RegisterEvent(IEventManager::SMP_PostSimTimeChange,
+                IEventManager::SMP_PostSimTimeChangeId);
+}
+
+XsmpEventManager::~XsmpEventManager() noexcept {
+  // the remaining asynchronous emissions are discarded
+  {
+    const std::scoped_lock lck{_dispatchMutex};
+    _stopDispatch = true;
+  }
+  _dispatchCv.notify_all();
+  for (auto &thread : _dispatchThreads) {
+    thread.join();
+  }
+  for (std::size_t chunk = 0; chunk < maxChunks; ++chunk) {
+    if (auto *events = _chunks[chunk].load()) {
+      for (std::size_t index = 0; index < (firstChunkSize << chunk); ++index) {
+        delete events[index].subscribers.load();
+      }
+      delete[] events;
+    }
+  }
+}
+
+std::pair<std::size_t, std::size_t>
+XsmpEventManager::Locate(std::size_t index) noexcept {
+  const auto position = index / firstChunkSize + 1;
+  std::size_t chunk = 0;
+  while ((position >> (chunk + 1)) != 0) {
+    ++chunk;
+  }
+  return {chunk, index - firstChunkSize * ((std::size_t{1} << chunk) - 1)};
+}
+
+XsmpEventManager::Event *
+XsmpEventManager::At(std::size_t index) const noexcept {
+  const auto [chunk, offset] = Locate(index);
+  auto *events = _chunks[chunk].load(std::memory_order_acquire);
+  return events ? events + offset : nullptr;
+}
+
+const XsmpEventManager::Event *
+XsmpEventManager::FindEvent(::Smp::Services::EventId event) const noexcept {
+  if (event <= 0 ||
+      static_cast<std::size_t>(event) >
+          _eventCount.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  const auto *entry = At(static_cast<std::size_t>(event - 1));
+  // a restored table may have holes
+  return entry->name.load(std::memory_order_acquire) ? entry : nullptr;
+}
+
+XsmpEventManager::Event *
+XsmpEventManager::FindEvent(::Smp::Services::EventId event) noexcept {
+  return const_cast<Event *>(std::as_const(*this).FindEvent(event));
+}
+
+void XsmpEventManager::RegisterEvent(std::string_view name,
+                                     ::Smp::Services::EventId event) {
+  if (event <= 0) {
+    ::Xsmp::Exception::throwInvalidEventId(this, event);
+  }
+  const auto [chunk, offset] = Locate(static_cast<std::size_t>(event - 1));
+  // more than 10^12 events: the table cannot grow anymore
+  if (chunk >= maxChunks) {
+    ::Xsmp::Exception::throwInvalidEventId(this, event);
+  }
+  auto *events = _chunks[chunk].load(std::memory_order_relaxed);
+  if (!events) {
+    events = new Event[firstChunkSize << chunk];
+    _chunks[chunk].store(events, std::memory_order_release);
+  }
+  const auto &interned = *_names.emplace(name).first;
+  events[offset].name.store(&interned, std::memory_order_release);
+  _ids.try_emplace(interned, event);
+  // publish the event
+  if (static_cast<std::size_t>(event) >
+      _eventCount.load(std::memory_order_relaxed)) {
+    _eventCount.store(static_cast<std::size_t>(event),
+                      std::memory_order_release);
   }
 }
 
@@ -95,55 +199,83 @@ XsmpEventManager::QueryEventId(::Smp::String8 eventName) {
   if (!eventName || eventName[0] == '\0') {
     ::Xsmp::Exception::throwInvalidEventName(this, eventName);
   }
-  auto eventsAccess = _events.write();
+  const std::scoped_lock lck{_mutex};
 
-  if (auto it = eventsAccess.get().find(eventName);
-      it != eventsAccess.get().end()) {
+  if (auto it = _ids.find(eventName); it != _ids.end()) {
     return it->second;
   }
 
-  auto eventId =
-      static_cast<::Smp::Services::EventId>(eventsAccess.get().size() + 1);
-
-  const auto &name =
-      eventsAccess.get().try_emplace(eventName, eventId).first->first;
-  eventsAccess.unlock();
-  _ids.write().get().try_emplace(eventId, name);
+  const auto eventId = static_cast<::Smp::Services::EventId>(
+      _eventCount.load(std::memory_order_relaxed) + 1);
+  RegisterEvent(eventName, eventId);
   return eventId;
 }
 
 const std::string &
 XsmpEventManager::GetEventName(::Smp::Services::EventId event) const {
-  auto idsAccess = _ids.read();
-  auto it = idsAccess.get().find(event);
-  if (it == idsAccess.get().end()) {
+  const auto *entry = FindEvent(event);
+  if (!entry) {
     ::Xsmp::Exception::throwInvalidEventId(this, event);
   }
-  return it->second;
+  return *entry->name.load(std::memory_order_acquire);
+}
+
+void XsmpEventManager::PublishSubscribers(
+    Event &entry, std::unique_ptr<const Subscribers> subscribers) {
+  // the previous snapshot may be read by an emission: it is released later
+  if (const auto *previous =
+          entry.subscribers.exchange(subscribers.release())) {
+    _retiredSubscribers.emplace_back(previous);
+  }
+}
+
+void XsmpEventManager::ReleaseRetiredSubscribers() {
+  // an emission that starts now reads the current snapshots: the retired ones
+  // are released when no emission is in progress nor queued
+  if (!_retiredSubscribers.empty() && _emitting.load() == 0 &&
+      _pendingCount.load() == 0) {
+    _retiredSubscribers.clear();
+  }
 }
 
 void XsmpEventManager::Subscribe(::Smp::Services::EventId event,
                                  const ::Smp::IEntryPoint *entryPoint) {
+  Subscribe(event, entryPoint, 0);
+}
+
+void XsmpEventManager::Subscribe(::Smp::Services::EventId event,
+                                 const ::Smp::IEntryPoint *entryPoint,
+                                 ::Smp::Int32 priority) {
 
   const auto &event_name = GetEventName(event);
   {
-    auto subscriptionAccess = _subscriptions.write();
-    if (auto it = subscriptionAccess.get().find(event);
-        it != subscriptionAccess.get().end()) {
-      auto &entryPoints = it->second;
-
-      if (std::find(entryPoints.begin(), entryPoints.end(), entryPoint) !=
-          entryPoints.end()) {
-        ::Xsmp::Exception::throwEntryPointAlreadySubscribed(this, entryPoint,
-                                                            event_name);
-      }
-      entryPoints.push_back(entryPoint);
-    } else {
-      subscriptionAccess.get().try_emplace(
-          event, std::vector<const ::Smp::IEntryPoint *>{entryPoint});
+    const std::scoped_lock lck{_mutex};
+    auto &entry = *FindEvent(event);
+    const auto *snapshot = entry.subscribers.load(std::memory_order_relaxed);
+    if (snapshot &&
+        std::find(snapshot->entryPoints.begin(), snapshot->entryPoints.end(),
+                  entryPoint) != snapshot->entryPoints.end()) {
+      ::Xsmp::Exception::throwEntryPointAlreadySubscribed(this, entryPoint,
+                                                          event_name);
     }
+    // the current snapshot may be in use by Emit(): replace it
+    auto subscribers = snapshot ? std::make_unique<Subscribers>(*snapshot)
+                                : std::make_unique<Subscribers>();
+    // after the subscribers with the same or a greater priority
+    const auto position = static_cast<std::ptrdiff_t>(
+        std::upper_bound(subscribers->priorities.begin(),
+                         subscribers->priorities.end(), priority,
+                         std::greater<>{}) -
+        subscribers->priorities.begin());
+    subscribers->entryPoints.insert(
+        subscribers->entryPoints.begin() + position, entryPoint);
+    subscribers->priorities.insert(subscribers->priorities.begin() + position,
+                                   priority);
+    PublishSubscribers(entry, std::move(subscribers));
   }
-  if (auto *logger = GetSimulator()->GetLogger()) {
+  if (auto *logger = GetSimulator()->GetLogger();
+      ::Xsmp::Helper::IsLogEnabled(logger, this,
+                                   ::Smp::Services::ILogger::LMK_Debug)) {
     logger->Log(this,
                 (::Xsmp::Helper::GetPath(entryPoint) + " subscribed to " +
                  event_name + ".")
@@ -156,62 +288,244 @@ void XsmpEventManager::Unsubscribe(::Smp::Services::EventId event,
                                    const ::Smp::IEntryPoint *entryPoint) {
 
   const auto &event_name = GetEventName(event);
-
-  auto subscriptionAccess = _subscriptions.write();
-  if (auto it = subscriptionAccess.get().find(event);
-      it != subscriptionAccess.get().end()) {
-
-    auto &entryPoints = it->second;
-    auto it2 = std::find(entryPoints.begin(), entryPoints.end(), entryPoint);
-    if (it2 != entryPoints.end()) {
-      entryPoints.erase(it2);
-      if (auto *logger = GetSimulator()->GetLogger()) {
-        logger->Log(this,
-                    (::Xsmp::Helper::GetPath(entryPoint) + " unsubscribed to " +
-                     event_name + ".")
-                        .c_str(),
-                    ::Smp::Services::ILogger::LMK_Debug);
+  {
+    const std::scoped_lock lck{_mutex};
+    auto &entry = *FindEvent(event);
+    if (const auto *snapshot =
+            entry.subscribers.load(std::memory_order_relaxed)) {
+      auto it = std::find(snapshot->entryPoints.begin(),
+                          snapshot->entryPoints.end(), entryPoint);
+      if (it == snapshot->entryPoints.end()) {
+        ::Xsmp::Exception::throwEntryPointNotSubscribed(this, entryPoint,
+                                                        event_name);
       }
-      return;
+      // the current snapshot may be in use by Emit(): replace it
+      auto subscribers = std::make_unique<Subscribers>(*snapshot);
+      const auto position = it - snapshot->entryPoints.begin();
+      subscribers->entryPoints.erase(subscribers->entryPoints.begin() +
+                                     position);
+      subscribers->priorities.erase(subscribers->priorities.begin() +
+                                    position);
+      PublishSubscribers(entry, std::move(subscribers));
+    } else {
+      ::Xsmp::Exception::throwEntryPointNotSubscribed(this, entryPoint,
+                                                      event_name);
     }
   }
-
-  ::Xsmp::Exception::throwEntryPointNotSubscribed(this, entryPoint, event_name);
+  if (auto *logger = GetSimulator()->GetLogger();
+      ::Xsmp::Helper::IsLogEnabled(logger, this,
+                                   ::Smp::Services::ILogger::LMK_Debug)) {
+    logger->Log(this,
+                (::Xsmp::Helper::GetPath(entryPoint) + " unsubscribed to " +
+                 event_name + ".")
+                    .c_str(),
+                ::Smp::Services::ILogger::LMK_Debug);
+  }
 }
 
 void XsmpEventManager::Emit(::Smp::Services::EventId event,
-                            ::Smp::Bool /*synchronous*/) {
+                            ::Smp::Bool synchronous) {
 
-  const auto &event_name = GetEventName(event);
-  if (auto *logger = GetSimulator()->GetLogger()) {
-    logger->Log(this, event_name.c_str(), ::Smp::Services::ILogger::LMK_Event);
-  }
-  auto subscriptionAccess = _subscriptions.read();
-  if (auto it = subscriptionAccess.get().find(event);
-      it != subscriptionAccess.get().end()) {
-    // copy the entrypoints
-    auto entryPoints = it->second;
-    subscriptionAccess.unlock();
-    for (const auto *entry_point : entryPoints) {
-      ::Xsmp::Helper::SafeExecute(GetSimulator(), entry_point);
+  const auto *entry = FindEvent(event);
+  if (!entry) {
+    ::Xsmp::Exception::throwInvalidEventId(this, event);
+  }
+  if (auto *logger = GetSimulator()->GetLogger();
+      ::Xsmp::Helper::IsLogEnabled(logger, this,
+                                   ::Smp::Services::ILogger::LMK_Event)) {
+    logger->Log(this, entry->name.load(std::memory_order_acquire)->c_str(),
+                ::Smp::Services::ILogger::LMK_Event);
+  }
+  // read the current snapshot: (un)subscriptions during the emission
+  // replace it and are taken into account by the next Emit()
+  const EmittingScope scope{_emitting};
+  const auto *subscribers = entry->subscribers.load(std::memory_order_acquire);
+  // the handlers of the simulator events change the simulator state: they are
+  // always executed by the emitting thread
+  if (!synchronous && event > IEventManager::SMP_PostSimTimeChangeId) {
+    if (subscribers && !subscribers->entryPoints.empty()) {
+      Post(event, subscribers);
+    }
+    return;
+  }
+  if (subscribers) {
+    ::Xsmp::Helper::SafeExecute(GetSimulator(),
+                                subscribers->entryPoints.data(),
+                                subscribers->entryPoints.size());
+  }
+}
+
+void XsmpEventManager::Flush() {
+  if (isDispatchThread) {
+    return;
+  }
+  if (_pendingCount.load(std::memory_order_acquire) != 0) {
+    std::unique_lock lck{_dispatchMutex};
+    _completedCv.wait(lck, [this] {
+      return _pendingCount.load(std::memory_order_relaxed) == 0;
+    });
+  }
+  // quiescent point: the queued emissions are completed
+  const std::scoped_lock lck{_mutex};
+  ReleaseRetiredSubscribers();
+}
+
+void XsmpEventManager::Post(::Smp::Services::EventId event,
+                            const Subscribers *subscribers) {
+  std::unique_lock lck{_dispatchMutex};
+  // a dispatch thread cannot wait for the others: it would dead lock
+  if (!isDispatchThread) {
+    _completedCv.wait(lck, [this] {
+      return _pendingCount.load(std::memory_order_relaxed) <
+             maxPendingEmissions;
+    });
+  }
+  if (_dispatchThreads.empty()) {
+    const auto count = std::clamp<std::size_t>(
+        std::thread::hardware_concurrency(), 1, maxDispatchThreads);
+    for (std::size_t i = 0; i < count; ++i) {
+      _dispatchThreads.emplace_back(&XsmpEventManager::Dispatch, this);
+    }
+  }
+  auto &pending = _pending[event];
+  pending.emissions.push_back(subscribers);
+  _pendingCount.fetch_add(1, std::memory_order_relaxed);
+  // only one thread at a time executes the emissions of an event
+  if (!pending.scheduled) {
+    pending.scheduled = true;
+    _readyEvents.push_back(event);
+    lck.unlock();
+    _dispatchCv.notify_one();
+  }
+}
+
+void XsmpEventManager::Dispatch() {
+  isDispatchThread = true;
+  std::unique_lock lck{_dispatchMutex};
+  while (true) {
+    _dispatchCv.wait(lck,
+                     [this] { return _stopDispatch || !_readyEvents.empty(); });
+    if (_stopDispatch) {
+      return;
     }
+    const auto event = _readyEvents.front();
+    _readyEvents.pop_front();
+    auto &emissions = _pending[event].emissions;
+    const auto *subscribers = emissions.front();
+    emissions.pop_front();
+    lck.unlock();
+
+    ::Xsmp::Helper::SafeExecute(GetSimulator(),
+                                subscribers->entryPoints.data(),
+                                subscribers->entryPoints.size());
+
+    lck.lock();
+    // the map may have been modified meanwhile
+    if (auto it = _pending.find(event); it->second.emissions.empty()) {
+      _pending.erase(it);
+    } else {
+      // let the other events progress before the next emission
+      _readyEvents.push_back(event);
+      _dispatchCv.notify_one();
+    }
+    _pendingCount.fetch_sub(1, std::memory_order_release);
+    _completedCv.notify_all();
   }
 }
 
+namespace {
+/// Version of the checkpoint layout, stored first. A checkpoint of the
+/// initial layout (a map of names and a map of subscribers) starts with the
+/// type hash of the map of names instead.
+enum class CheckpointVersion : ::Smp::UInt32 {
+  /// a map of names, a map of subscribers and a map of priorities
+  Priorities = 1
+};
+} // namespace
+
 void XsmpEventManager::Restore(::Smp::IStorageReader *reader) {
-  ::Xsmp::Persist::Restore(GetSimulator(), this, reader, _events.write().get(),
-                           _subscriptions.write().get());
-  // rebuild _ids map from _events
-  auto idsAccess = _ids.write();
-  idsAccess.get().clear();
-  for (const auto &[name, id] : _events.read().get()) {
-    idsAccess.get().try_emplace(id, name);
+  std::unordered_map<std::string, ::Smp::Services::EventId> events;
+  std::unordered_map<::Smp::Services::EventId,
+                     std::vector<const ::Smp::IEntryPoint *>>
+      subscriptions;
+  std::unordered_map<::Smp::Services::EventId, std::vector<::Smp::Int32>>
+      priorities;
+  std::size_t hash = 0;
+  ::Xsmp::Persist::Restore(GetSimulator(), reader, hash);
+  if (hash == typeid(CheckpointVersion).hash_code()) {
+    auto version = CheckpointVersion::Priorities;
+    ::Xsmp::Persist::Restore(GetSimulator(), reader, version);
+    if (version != CheckpointVersion::Priorities) {
+      ::Xsmp::Exception::throwCannotRestore(this, typeid(version).name());
+    }
+    ::Xsmp::Persist::Restore(GetSimulator(), this, reader, events,
+                             subscriptions, priorities);
+  } else {
+    // initial layout: the priorities are restored to 0
+    if (hash != typeid(events).hash_code()) {
+      ::Xsmp::Exception::throwCannotRestore(this, typeid(events).name());
+    }
+    ::Xsmp::Persist::Restore(GetSimulator(), reader, events);
+    ::Xsmp::Persist::Restore(GetSimulator(), this, reader, subscriptions);
   }
+
+  const std::scoped_lock lck{_mutex};
+  const auto previousCount = _eventCount.load(std::memory_order_relaxed);
+  // the events registered after the checkpoint are not valid anymore
+  for (std::size_t index = 0; index < previousCount; ++index) {
+    if (auto *entry = At(index)) {
+      entry->name.store(nullptr, std::memory_order_release);
+    }
+  }
+  _ids.clear();
+  _eventCount.store(0, std::memory_order_release);
+  for (const auto &[name, id] : events) {
+    RegisterEvent(name, id);
+  }
+  const auto count = std::max(previousCount,
+                              _eventCount.load(std::memory_order_relaxed));
+  for (std::size_t index = 0; index < count; ++index) {
+    if (auto *entry = At(index)) {
+      const auto id = static_cast<::Smp::Services::EventId>(index + 1);
+      std::unique_ptr<Subscribers> subscribers;
+      if (auto it = subscriptions.find(id); it != subscriptions.end()) {
+        subscribers = std::make_unique<Subscribers>();
+        subscribers->entryPoints = std::move(it->second);
+        if (auto priority = priorities.find(id);
+            priority != priorities.end() &&
+            priority->second.size() == subscribers->entryPoints.size()) {
+          subscribers->priorities = std::move(priority->second);
+        } else {
+          subscribers->priorities.resize(subscribers->entryPoints.size(), 0);
+        }
+      }
+      PublishSubscribers(*entry, std::move(subscribers));
+    }
+  }
+  ReleaseRetiredSubscribers();
 }
 
 void XsmpEventManager::Store(::Smp::IStorageWriter *writer) {
-  ::Xsmp::Persist::Store(GetSimulator(), this, writer, _events.read().get(),
-                         _subscriptions.read().get());
+  std::unordered_map<std::string, ::Smp::Services::EventId> events;
+  std::unordered_map<::Smp::Services::EventId,
+                     std::vector<const ::Smp::IEntryPoint *>>
+      subscriptions;
+  std::unordered_map<::Smp::Services::EventId, std::vector<::Smp::Int32>>
+      priorities;
+  {
+    const std::scoped_lock lck{_mutex};
+    for (const auto &[name, id] : _ids) {
+      events.try_emplace(std::string{name}, id);
+      if (const auto *subscribers =
+              FindEvent(id)->subscribers.load(std::memory_order_relaxed)) {
+        subscriptions.try_emplace(id, subscribers->entryPoints);
+        priorities.try_emplace(id, subscribers->priorities);
+      }
+    }
+  }
+  ::Xsmp::Persist::Store(GetSimulator(), this, writer,
+                         CheckpointVersion::Priorities, events, subscriptions,
+                         priorities);
 }
 
 } // namespace Xsmp::Services
@@ -18,11 +18,21 @@
 #include <Smp/IEntryPoint.h>
 #include <Smp/PrimitiveTypes.h>
 #include <Smp/Services/EventId.h>
+#include <Xsmp/Helper.h>
 #include <Xsmp/Services/XsmpEventManagerGen.h>
-#include <Xsmp/ThreadSafeData.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 // ----------------------------------------------------------------------------
@@ -31,7 +41,8 @@
 
 namespace Xsmp::Services {
 
-class XsmpEventManager final : public XsmpEventManagerGen {
+class XsmpEventManager final : public XsmpEventManagerGen,
+                               public ::Xsmp::IEventDispatcher {
 public:
   // ------------------------------------------------------------------------------------
   // -------------------------- Constructors/Destructor
@@ -46,7 +57,7 @@ public:
                    ::Smp::IComposite *parent, ::Smp::ISimulator *simulator);
 
   /// Virtual destructor to release memory.
-  ~XsmpEventManager() noexcept override = default;
+  ~XsmpEventManager() noexcept override;
 
   /// Get unique event identifier for an event name.
   /// It is guaranteed that this method will always return the same
@@ -71,6 +82,18 @@ public:
   void Subscribe(::Smp::Services::EventId event,
                  const ::Smp::IEntryPoint *entryPoint) override;
 
+  /// Subscribe entry point to a global event with a priority.
+  /// Entry points are called by decreasing priority, then in the order they
+  /// have been subscribed. Subscribe() without priority uses priority 0.
+  /// @param   event Event identifier of global event to subscribe to.
+  /// @param   entryPoint Entry point to subscribe to global event.
+  /// @param   priority Priority of the entry point.
+  /// @throws  ::Smp::Services::EntryPointAlreadySubscribed
+  /// @throws  ::Smp::Services::InvalidEventId
+  void Subscribe(::Smp::Services::EventId event,
+                 const ::Smp::IEntryPoint *entryPoint,
+                 ::Smp::Int32 priority) override;
+
   /// Unsubscribe entry point from a global event.
   /// This method raises an exception of type InvalidEventId when
   /// called with an invalid event identifier. When the entry point
@@ -91,13 +114,18 @@ public:
   /// global event with the given identifier at the time Emit() is
   /// called. Entry point subscription/unsubscription during the
   /// execution of Emit() is taken into account the next time Emit()
-  /// is called. Entry points will be called in the order they have
-  /// been subscribed to the global event.
+  /// is called. Entry points will be called by decreasing priority, then
+  /// in the order they have been subscribed to the global event.
   /// Only the simulation environment itself is allowed to emit
   /// events for changes of the simulator state. While an event for
   /// such a state transition is emitted, subscribed event handlers
   /// are not allowed to call another state transition of the
   /// simulator.
+  /// An asynchronous emission of a user event is executed by a bounded pool
+  /// of threads: the emissions of a same event are executed in order. The
+  /// scheduler waits for the pending asynchronous emissions before each
+  /// simulation time change. The pre-defined SMP events are always emitted
+  /// synchronously.
   /// @param   event Event identifier of global event to emit.
   /// @param   synchronous Flag whether to emit the given event
   ///          synchronously (the default) or asynchronously.
@@ -105,6 +133,11 @@ public:
   void Emit(::Smp::Services::EventId event,
             ::Smp::Bool synchronous = true) override;
 
+  /// Wait until all the pending asynchronous emissions are executed, then
+  /// release the snapshots of subscribers replaced since the last call.
+  /// This method does nothing when called from an asynchronous emission.
+  void Flush() override;
+
   void Restore(::Smp::IStorageReader *reader) override;
 
   void Store(::Smp::IStorageWriter *writer) override;
@@ -112,19 +145,100 @@ public:
 private:
   friend class ::Xsmp::Component::Helper;
 
-  Xsmp::ThreadSafeData<
-      std::unordered_map<std::string, ::Smp::Services::EventId>>
-      _events;
-
-  Xsmp::ThreadSafeData<
-      std::unordered_map<::Smp::Services::EventId, const std::string &>>
-      _ids;
-
-  Xsmp::ThreadSafeData<std::unordered_map<
-      ::Smp::Services::EventId, std::vector<const ::Smp::IEntryPoint *>>>
-      _subscriptions;
+  /// The subscribers of an event, by decreasing priority then by
+  /// subscription order
+  struct Subscribers {
+    std::vector<const ::Smp::IEntryPoint *> entryPoints;
+    std::vector<::Smp::Int32> priorities;
+  };
+
+  /// An event, at index (id - 1) of the event table
+  struct Event {
+    /// the interned name of the event
+    std::atomic<const std::string *> name{nullptr};
+    /// immutable snapshot of the subscribers: Subscribe() and Unsubscribe()
+    /// atomically replace it, Emit() only reads it
+    std::atomic<const Subscribers *> subscribers{nullptr};
+  };
+  static constexpr std::size_t firstChunkSize = 256;
+  static constexpr std::size_t maxChunks = 32;
+
+  // the event table is allocated by chunks of doubling sizes that are never
+  // moved nor released before the destruction: readers access it without lock
+  std::array<std::atomic<Event *>, maxChunks> _chunks{};
+  // the greatest valid event id
+  std::atomic<std::size_t> _eventCount{0};
+
+  // protects the modifications of the event table, the names and the ids
+  mutable std::mutex _mutex;
+  // interned event names (nodes are never moved)
+  std::unordered_set<std::string> _names;
+  std::unordered_map<std::string_view, ::Smp::Services::EventId> _ids;
+  // replaced snapshots of subscribers that may still be read by an emission
+  std::vector<std::unique_ptr<const Subscribers>> _retiredSubscribers;
+  // number of Emit() calls in progress
+  std::atomic<std::size_t> _emitting{0};
+
+  /// Locate an index of the event table
+  /// @param index the index of the event (id - 1)
+  /// @return the chunk and the offset in the chunk
+  static std::pair<std::size_t, std::size_t> Locate(std::size_t index) noexcept;
+
+  /// Get an entry of the event table
+  /// @param index the index of the event (id - 1)
+  /// @return the entry or nullptr if its chunk is not allocated
+  Event *At(std::size_t index) const noexcept;
+
+  /// Find an event
+  /// @return the event or nullptr if the id is invalid
+  const Event *FindEvent(::Smp::Services::EventId event) const noexcept;
+  Event *FindEvent(::Smp::Services::EventId event) noexcept;
+
+  /// Register an event (the mutex must be locked)
+  /// @param name the name of the event
+  /// @param event the id of the event
+  void RegisterEvent(std::string_view name, ::Smp::Services::EventId event);
 
   const std::string &GetEventName(::Smp::Services::EventId event) const;
+
+  /// Replace the snapshot of the subscribers of an event (the mutex must be
+  /// locked). The previous snapshot is retired.
+  /// @param entry the event
+  /// @param subscribers the new snapshot, or nullptr if there is no subscriber
+  void PublishSubscribers(Event &entry,
+                          std::unique_ptr<const Subscribers> subscribers);
+
+  /// Release the retired snapshots if no emission may read them (the mutex
+  /// must be locked)
+  void ReleaseRetiredSubscribers();
+
+  /// The pending asynchronous emissions of an event
+  struct PendingEmissions {
+    std::deque<const Subscribers *> emissions;
+    /// whether the event is in the ready queue or executed by a thread
+    bool scheduled{false};
+  };
+  static constexpr std::size_t maxDispatchThreads = 4;
+  static constexpr std::size_t maxPendingEmissions = 1024;
+
+  // protects the asynchronous emissions
+  std::mutex _dispatchMutex;
+  // notifies the dispatch threads of a ready event or of the termination
+  std::condition_variable _dispatchCv;
+  // notifies the emitters of a completed emission
+  std::condition_variable _completedCv;
+  std::unordered_map<::Smp::Services::EventId, PendingEmissions> _pending;
+  // events with pending emissions that are not executed by a thread
+  std::deque<::Smp::Services::EventId> _readyEvents;
+  // number of queued and running emissions
+  std::atomic<std::size_t> _pendingCount{0};
+  bool _stopDispatch{false};
+  std::vector<std::thread> _dispatchThreads;
+
+  /// Queue an asynchronous emission
+  void Post(::Smp::Services::EventId event, const Subscribers *subscribers);
+  /// Execute the asynchronous emissions until the termination
+  void Dispatch();
 };
 } // namespace Xsmp::Services
 
@@ -18,6 +18,7 @@
 #include <Smp/IStorageReader.h>
 #include <Smp/IStorageWriter.h>
 #include <Smp/PrimitiveTypes.h>
+#include <Smp/Services/ILogger.h>
 #include <Smp/Services/ITimeKeeper.h>
 #include <Smp/Services/LogMessageKind.h>
 #include <Xsmp/Component.h>
@@ -29,9 +30,17 @@
 #include <Xsmp/Persist/StdVector.h>
 #include <Xsmp/Services/XsmpLogger.h>
 #include <Xsmp/Services/XsmpLoggerGen.h>
+#include <Xsmp/Services/XsmpLoggerLayout.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -40,11 +49,11 @@
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <queue>
 #include <regex>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -72,62 +81,6 @@ inline void trim(std::string &str) {
   ltrim(str);
   rtrim(str);
 }
-inline std::string unescape(std::string_view str) {
-  std::string result;
-  result.reserve(str.size());
-  auto it = str.begin();
-  while (it != str.end()) {
-    if (*it == '\\') {
-      if (++it != str.end()) {
-        switch (*it) {
-        case '\'':
-          result += '\'';
-          break;
-        case '"':
-          result += '\"';
-          break;
-        case '?':
-          result += '\?';
-          break;
-        case '\\':
-          result += '\\';
-          break;
-        case 'a':
-          result += '\a';
-          break;
-        case 'b':
-          result += '\b';
-          break;
-        case 'f':
-          result += '\f';
-          break;
-        case 'n':
-          result += '\n';
-          break;
-        case 'r':
-          result += '\r';
-          break;
-        case 't':
-          result += '\t';
-          break;
-        case 'v':
-          result += '\v';
-          break;
-        default:
-          result += *it;
-          break;
-        }
-        ++it;
-      }
-      continue;
-    }
-    result += *it;
-
-    ++it;
-  }
-  return result;
-}
-
 inline std::vector<std::string> split(std::string_view str, char delimiter) {
   std::vector<std::string> result;
 
@@ -147,159 +100,139 @@ inline std::vector<std::string> split(std::string_view str, char delimiter) {
   }
   return result;
 }
-} // namespace
-struct LogEntry {
-  std::string sender;
-  std::string msg;
-  std::string kind;
-  ::Xsmp::DateTime zuluTime;
-  ::Xsmp::Duration simulationTime;
-  ::Xsmp::DateTime epochTime;
-  ::Xsmp::Duration missionTime;
-};
-
-constexpr const char *_basePath = "log";
-
-class Layout {
-public:
-  Layout() = default;
-  Layout(const Layout &) = delete;
-  Layout(Layout &&) = delete;
-  Layout &operator=(const Layout &) = delete;
-  Layout &operator=(Layout &&) = delete;
-  virtual ~Layout() noexcept = default;
-  virtual void Append(std::ostream &stream, const LogEntry &entry) const = 0;
-};
+std::size_t
+GetUnsigned(const std::map<std::string, std::string, std::less<>> &properties,
+            const std::string &key, std::size_t defaultValue) {
+  if (auto value = properties.find(key); value != properties.end()) {
+    try {
+      return std::stoull(value->second);
+    } catch (const std::exception &) {
+      std::cerr << "Invalid value of " << key << ": " << value->second << '\n';
+    }
+  }
+  return defaultValue;
+}
 
-class SimpleLayout final : public Layout {
-public:
-  SimpleLayout() = default;
-  SimpleLayout(const SimpleLayout &) = delete;
-  SimpleLayout(SimpleLayout &&) = delete;
-  SimpleLayout &operator=(const SimpleLayout &) = delete;
-  SimpleLayout &operator=(SimpleLayout &&) = delete;
-  ~SimpleLayout() noexcept override = default;
-  void Append(std::ostream &stream, const LogEntry &entry) const override {
-    stream << entry.simulationTime << "\t" << entry.sender << '\t' << entry.kind
-           << '\t' << entry.msg << '\n';
+/// match a glob pattern: '*' matches any sequence of characters (including
+/// the path separators) and '?' matches any character
+bool GlobMatch(std::string_view pattern, std::string_view str) {
+  std::size_t patternPos = 0;
+  std::size_t strPos = 0;
+  // position of the last '*' in the pattern and the matching position in str
+  auto starPos = std::string_view::npos;
+  std::size_t starMatch = 0;
+  while (strPos < str.size()) {
+    if (patternPos < pattern.size() &&
+        (pattern[patternPos] == '?' || pattern[patternPos] == str[strPos])) {
+      ++patternPos;
+      ++strPos;
+    } else if (patternPos < pattern.size() && pattern[patternPos] == '*') {
+      starPos = patternPos++;
+      starMatch = strPos;
+    } else if (starPos != std::string_view::npos) {
+      // let the last '*' match one more character
+      patternPos = starPos + 1;
+      strPos = ++starMatch;
+    } else {
+      return false;
+    }
   }
-};
+  while (patternPos < pattern.size() && pattern[patternPos] == '*') {
+    ++patternPos;
+  }
+  return patternPos == pattern.size();
+}
+} // namespace
+constexpr const char *_basePath = "log";
 
-class PatternLayout final : public Layout {
+/// Filter of the sender paths of an appender.
+/// The "<path>.pathPattern" property is a comma separated list of glob
+/// patterns (e.g. /Model/*, */Sub?/Field) and the "<path>.path" property is a
+/// regex. The decision is cached for each sender path.
+class PathFilter {
 public:
-  PatternLayout(
+  PathFilter(
       const std::string &path,
-      const std::map<std::string, std::string, std::less<>> &properties)
-      : _pattern{ComputePatternLayout(path, properties)} {}
-  ~PatternLayout() noexcept override = default;
-  PatternLayout(const PatternLayout &) = delete;
-  PatternLayout(PatternLayout &&) = delete;
-  PatternLayout &operator=(const PatternLayout &) = delete;
-  PatternLayout &operator=(PatternLayout &&) = delete;
-  void Append(std::ostream &stream, const LogEntry &entry) const override {
-    using namespace std::chrono;
-
-    auto format = [&stream](std::string::const_iterator &it,
-                            const auto &value) {
-      if (auto fmt = GetFormatting(it); fmt.empty()) {
-        stream << static_cast<::Smp::Int64>(value);
-      } else {
-        value.to_stream(stream, fmt);
-      }
-    };
-
-    auto it = _pattern.begin();
-    while (it != _pattern.end()) {
-      if (*it == '%') {
-        ++it;
-        switch (*it) {
-        case 'p':
-          stream << entry.sender;
-          break;
-        case 'k':
-          stream << entry.kind;
-          break;
-        case 'm':
-          stream << entry.msg;
-          break;
-        case 'd':
-          format(it, entry.zuluTime);
-          break;
-        case 'S':
-          format(it, entry.simulationTime);
-          break;
-        case 'E':
-          format(it, entry.epochTime);
-          break;
-        case 'M':
-          format(it, entry.missionTime);
-          break;
-        case 't':
-          stream << '\t';
-          break;
-        case 'n':
-          stream << '\n';
-          break;
-        case '%':
-          stream << '%';
-          break;
-        default:
-          stream << "%" << *it;
-          break;
-        }
+      const std::map<std::string, std::string, std::less<>> &properties) {
+    if (auto patterns = properties.find(path + ".pathPattern");
+        patterns != properties.end()) {
+      for (const auto &pattern : split(patterns->second, ',')) {
+        // split the literal prefix from the remaining glob pattern
+        const auto wildcard = pattern.find_first_of("*?");
+        _patterns.push_back({pattern.substr(0, wildcard),
+                             wildcard == std::string::npos
+                                 ? std::string{}
+                                 : pattern.substr(wildcard)});
       }
-      // write all other chars
-      else {
-        stream << *it;
+      _enabled = true;
+    }
+    if (auto pathRegex = properties.find(path + ".path");
+        pathRegex != properties.end()) {
+      try {
+        _pathRegex = std::regex{unescape(pathRegex->second),
+                                std::regex::ECMAScript | std::regex::optimize};
+        _enabled = true;
+      } catch (const std::regex_error &e) {
+        std::cerr << "Invalid regex expression: \"" << pathRegex->second
+                  << "\" ->" << e.what() << '\n';
       }
-      ++it;
     }
-    stream.flush();
+  }
+
+  /// @return true if the sender path matches a glob pattern or the regex
+  [[nodiscard]] bool Accepts(const std::string &sender) {
+    if (!_enabled) {
+      return true;
+    }
+    if (auto it = _decisions.find(sender); it != _decisions.end()) {
+      return it->second;
+    }
+    // bound the memory used by transient senders
+    if (_decisions.size() >= maxCachedDecisions) {
+      _decisions.clear();
+    }
+    return _decisions.emplace(sender, Match(sender)).first->second;
   }
 
 private:
-  std::string _pattern;
-
-  static std::string
-  ComputePatternLayout(const std::string &path,
-                       const std::map<std::string, std::string, std::less<>>
-                           &properties) noexcept {
-
-    if (auto pattern = properties.find(path + ".conversionPattern");
-        pattern != properties.end()) {
-      /*
-       *  %p Output the Path of the sender IObject
-       *  %k Output the message kind name
-       *  %m Output the message
-       *  %d Output the Date of the msg
-       * %S Output the Simulation Time
-       * %E Output the epoch time
-       * %M Output the mission time
-       * %n Output std::endl
-       * %t Output \t
-       * %% Output a single %
-       */
-      return unescape(pattern->second);
-    }
-    // use default pattern
-    return "%d{%F %T}%t%S%t%p%t%k%t%m%n";
-  }
-  static std::string GetFormatting(std::string::const_iterator &it) noexcept {
-    std::string formatting;
-    if (it[1] == '{') {
-      it += 2;
-      while (*it != '}') {
-        formatting.push_back(*it);
-        ++it;
+  struct Pattern {
+    std::string prefix;
+    /// the remaining pattern, starting with a wildcard
+    std::string glob;
+  };
+  static constexpr std::size_t maxCachedDecisions = 4096;
+  std::vector<Pattern> _patterns;
+  std::optional<std::regex> _pathRegex;
+  std::unordered_map<std::string, bool> _decisions;
+  bool _enabled{false};
+
+  [[nodiscard]] bool Match(const std::string &sender) const {
+    const std::string_view view{sender};
+    for (const auto &pattern : _patterns) {
+      if (view.substr(0, pattern.prefix.size()) != pattern.prefix) {
+        continue;
+      }
+      const auto rest = view.substr(pattern.prefix.size());
+      // exact path
+      if (pattern.glob.empty()) {
+        if (rest.empty()) {
+          return true;
+        }
+      }
+      // prefix or glob
+      else if (pattern.glob == "*" || GlobMatch(pattern.glob, rest)) {
+        return true;
       }
     }
-    return formatting;
+    return _pathRegex && std::regex_match(sender, *_pathRegex);
   }
 };
+
 class Appender {
 public:
   Appender(const std::string &path,
-           const std::map<std::string, std::string, std::less<>> &properties) {
+           const std::map<std::string, std::string, std::less<>> &properties)
+      : _pathFilter{path, properties} {
     auto key = path + ".layout";
     if (auto layout = properties.find(key); layout != properties.end()) {
 
@@ -324,17 +257,6 @@ public:
         _levels.emplace(value);
       }
     }
-
-    if (auto pathRegex = properties.find(path + ".path");
-        pathRegex != properties.end()) {
-      try {
-        _pathRegex = std::regex{unescape(pathRegex->second),
-                                std::regex::ECMAScript | std::regex::optimize};
-      } catch (const std::regex_error &e) {
-        std::cerr << "Invalid regex expression: \"" << pathRegex->second
-                  << "\" ->" << e.what() << '\n';
-      }
-    }
   }
   virtual ~Appender() noexcept = default;
   Appender(const Appender &) = delete;
@@ -344,22 +266,32 @@ public:
 
   void Append(const LogEntry &entry) {
 
-    if ((_levels.empty() || _levels.find(entry.kind) != _levels.end()) &&
-        (!_pathRegex || std::regex_match(entry.sender, *_pathRegex))) {
+    if (Accepts(entry.kind) && _pathFilter.Accepts(entry.sender)) {
       DoAppend(entry);
     }
   }
 
+  /// the path filter is not considered: it requires the sender path
+  [[nodiscard]] bool Accepts(const std::string &kind) const {
+    return _levels.empty() || _levels.find(kind) != _levels.end();
+  }
+
+  /// write the buffered entries
+  virtual void Flush() = 0;
+
 protected:
   virtual void DoAppend(const LogEntry &entry) = 0;
   void Append(std::ostream &stream, const LogEntry &entry) const {
     _layout->Append(stream, entry);
   }
+  void Format(std::string &buffer, const LogEntry &entry) const {
+    _layout->Format(buffer, entry);
+  }
 
 private:
   std::unique_ptr<Layout> _layout;
   std::unordered_set<std::string> _levels;
-  std::optional<std::regex> _pathRegex;
+  PathFilter _pathFilter;
 };
 
 class ConsoleAppender final : public Appender {
@@ -377,22 +309,66 @@ public:
     const std::scoped_lock lck{_mutex};
     Append(std::cout, entry);
   }
+  void Flush() override {
+    const std::scoped_lock lck{_mutex};
+    std::cout.flush();
+  }
 };
 std::mutex ConsoleAppender::_mutex;
 
+/// Appender writing the entries to a text file.
+/// The entries are formatted in a buffer that is written in a single call when
+/// it is full or when the flush interval has elapsed.
+/// The file is rolled over by size and/or by time: <File> is renamed
+/// <File>.1, <File>.1 is renamed <File>.2 ... up to <File>.<MaxBackupIndex>.
 class FileAppender final : public Appender {
 
 public:
   FileAppender(
       const std::string &path,
       const std::map<std::string, std::string, std::less<>> &properties)
-      : Appender(path, properties), _stream{GetFileName(path, properties)} {}
-  ~FileAppender() noexcept override = default;
+      : Appender(path, properties), _fileName{GetFileName(path, properties)},
+        _bufferSize{GetUnsigned(properties, path + ".BufferSize", 65536)},
+        _flushInterval{static_cast<std::chrono::milliseconds::rep>(
+            GetUnsigned(properties, path + ".FlushInterval", 1000))},
+        _maxFileSize{GetUnsigned(properties, path + ".MaxFileSize", 0)},
+        _rolloverInterval{static_cast<std::chrono::seconds::rep>(
+            GetUnsigned(properties, path + ".RolloverInterval", 0))},
+        _maxBackupIndex{GetUnsigned(properties, path + ".MaxBackupIndex", 1)} {
+    _buffer.reserve(_bufferSize);
+    Open();
+  }
+  ~FileAppender() noexcept override { Write(_buffer.size()); }
   FileAppender(const FileAppender &) = delete;
   FileAppender &operator=(const FileAppender &) = delete;
   FileAppender(FileAppender &&) = delete;
   FileAppender &operator=(FileAppender &&) = delete;
-  void DoAppend(const LogEntry &entry) override { Append(_stream, entry); }
+  void DoAppend(const LogEntry &entry) override {
+    if (IsRolloverTimeElapsed()) {
+      Write(_buffer.size());
+      Rollover();
+    }
+    const auto offset = _buffer.size();
+    Format(_buffer, entry);
+    // the entry does not fit in the file: write it in the next one
+    if (_maxFileSize != 0 && _fileSize + _buffer.size() > _maxFileSize &&
+        _fileSize + offset != 0) {
+      Write(offset);
+      Rollover();
+    }
+    if (_buffer.size() >= _bufferSize) {
+      Write(_buffer.size());
+    }
+  }
+  void Flush() override {
+    if (!_buffer.empty() &&
+        std::chrono::steady_clock::now() - _lastWrite >= _flushInterval) {
+      Write(_buffer.size());
+    }
+    if (IsRolloverTimeElapsed() && _fileSize != 0) {
+      Rollover();
+    }
+  }
 
 private:
   static std::string GetFileName(
@@ -403,29 +379,327 @@ private:
     }
     return "simulator.log";
   }
+  void Open() {
+    // the buffering is done by the appender
+    _stream.rdbuf()->pubsetbuf(nullptr, 0);
+    _stream.open(_fileName, std::ios::out | std::ios::trunc);
+    _fileSize = 0;
+    _openTime = std::chrono::steady_clock::now();
+  }
+  /// write the first bytes of the buffer
+  void Write(std::size_t size) {
+    if (size != 0) {
+      _stream.write(_buffer.data(), static_cast<std::streamsize>(size));
+      _fileSize += size;
+      _buffer.erase(0, size);
+    }
+    _lastWrite = std::chrono::steady_clock::now();
+  }
+  [[nodiscard]] bool IsRolloverTimeElapsed() const {
+    return _rolloverInterval.count() != 0 &&
+           std::chrono::steady_clock::now() - _openTime >= _rolloverInterval;
+  }
+  void Rollover() {
+    _stream.close();
+    for (auto index = _maxBackupIndex; index > 0; --index) {
+      const auto target = _fileName + "." + std::to_string(index);
+      std::remove(target.c_str());
+      const auto source = index == 1 ? _fileName
+                                     : _fileName + "." +
+                                           std::to_string(index - 1);
+      std::rename(source.c_str(), target.c_str());
+    }
+    Open();
+  }
+  std::string _fileName;
+  std::size_t _bufferSize;
+  std::chrono::milliseconds _flushInterval;
+  std::size_t _maxFileSize;
+  std::chrono::seconds _rolloverInterval;
+  std::size_t _maxBackupIndex;
   std::ofstream _stream;
+  std::string _buffer;
+  std::size_t _fileSize{0};
+  std::chrono::steady_clock::time_point _openTime;
+  std::chrono::steady_clock::time_point _lastWrite{
+      std::chrono::steady_clock::now()};
 };
-class LoggerProcessor {
+
+class BinaryFileAppender final : public Appender {
+
 public:
-  LoggerProcessor() {
-    auto properties = parseProperties();
+  BinaryFileAppender(
+      const std::string &path,
+      const std::map<std::string, std::string, std::less<>> &properties)
+      : Appender(path, properties), _writer{GetFileName(path, properties)} {}
+  ~BinaryFileAppender() noexcept override = default;
+  BinaryFileAppender(const BinaryFileAppender &) = delete;
+  BinaryFileAppender &operator=(const BinaryFileAppender &) = delete;
+  BinaryFileAppender(BinaryFileAppender &&) = delete;
+  BinaryFileAppender &operator=(BinaryFileAppender &&) = delete;
+  void DoAppend(const LogEntry &entry) override { _writer.Write(entry); }
+  void Flush() override { _writer.Flush(); }
 
-    if (auto rootLogger =
-            properties.find(std::string(_basePath) + ".rootLogger");
-        rootLogger != properties.end()) {
-      for (const auto &appender : split(rootLogger->second, ',')) {
-        CreateAppender(appender, properties);
+private:
+  static std::string GetFileName(
+      const std::string &path,
+      const std::map<std::string, std::string, std::less<>> &properties) {
+    if (auto file = properties.find(path + ".File"); file != properties.end()) {
+      return file->second;
+    }
+    return "simulator.xlog";
+  }
+  BinaryLogWriter _writer;
+};
+/// What to do when a log message is pushed into a full queue
+enum class OverflowPolicy {
+  /// wait until the logger thread makes room (no message is lost)
+  Block,
+  /// discard the oldest message of the queue
+  DropOldest,
+  /// discard the new message
+  Drop
+};
+
+/// A log message, preallocated in the queue
+struct alignas(64) LogRecord {
+  /// size of the text stored inline: larger texts use largeText
+  static constexpr std::size_t inlineSize = 256;
+
+  /// sequence number of the bounded queue
+  std::atomic<std::size_t> sequence{0};
+  ::Smp::DateTime zuluTime{};
+  ::Smp::Duration simulationTime{};
+  ::Smp::DateTime epochTime{};
+  ::Smp::Duration missionTime{};
+  /// the interned kind, its name is resolved by the logger thread
+  ::Smp::Services::LogMessageKind kind{};
+  /// sizes of the sender path and the message
+  std::size_t senderSize{};
+  std::size_t msgSize{};
+  std::array<char, inlineSize> text{};
+  std::string largeText;
+
+  void SetText(std::string_view sender, std::string_view msg) {
+    senderSize = sender.size();
+    msgSize = msg.size();
+    char *out = text.data();
+    if (senderSize + msgSize > inlineSize) {
+      // keep the capacity for the next large messages
+      largeText.resize(senderSize + msgSize);
+      out = largeText.data();
+    }
+    sender.copy(out, senderSize);
+    msg.copy(out + senderSize, msgSize);
+  }
+  [[nodiscard]] const char *Text() const noexcept {
+    return senderSize + msgSize > inlineSize ? largeText.data() : text.data();
+  }
+};
+
+/// Registry of the log message kinds.
+/// The kinds are interned: the name of a kind is read without any lock and is
+/// kept until the destruction of the registry.
+class LogMessageKinds {
+public:
+  /// create the registry with the pre-defined kinds: keep ordered
+  LogMessageKinds() {
+    for (const auto *name :
+         {::Smp::Services::ILogger::LMK_InformationName,
+          ::Smp::Services::ILogger::LMK_EventName,
+          ::Smp::Services::ILogger::LMK_WarningName,
+          ::Smp::Services::ILogger::LMK_ErrorName,
+          ::Smp::Services::ILogger::LMK_DebugName}) {
+      Add(name);
+    }
+  }
+
+  /// get the kind of a name, it is added if needed
+  ::Smp::Services::LogMessageKind Query(std::string_view name) {
+    const std::scoped_lock lck{_mutex};
+    if (auto it = _kinds.find(name); it != _kinds.end()) {
+      return it->second;
+    }
+    return Add(name);
+  }
+
+  /// get the name of a kind without lock
+  /// @return the name of the kind or nullptr if the kind is unknown
+  [[nodiscard]] const std::string *
+  Find(::Smp::Services::LogMessageKind kind) const noexcept {
+    // the index is a direct cast from ::Smp::Services::LogMessageKind to
+    // ::Smp::UInt32
+    const auto index = static_cast<::Smp::UInt32>(kind);
+    if (index >= _count.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    const auto [chunk, offset] = Locate(index);
+    return _chunks[chunk]
+        .load(std::memory_order_acquire)[offset]
+        .load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] std::vector<std::string> GetNames() const {
+    const std::scoped_lock lck{_mutex};
+    std::vector<std::string> names;
+    const auto count = _count.load(std::memory_order_relaxed);
+    names.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+      names.push_back(
+          *Find(static_cast<::Smp::Services::LogMessageKind>(index)));
+    }
+    return names;
+  }
+
+  void SetNames(const std::vector<std::string> &names) {
+    const std::scoped_lock lck{_mutex};
+    _kinds.clear();
+    const auto count = _count.load(std::memory_order_relaxed);
+    for (std::size_t index = 0; index < names.size(); ++index) {
+      const auto *name =
+          index < count
+              ? Find(static_cast<::Smp::Services::LogMessageKind>(index))
+              : nullptr;
+      if (!name || *name != names[index]) {
+        // the previous name is kept: it may be read by the logger thread
+        name = &_names.emplace_back(names[index]);
+        Publish(index, name);
       }
+      _kinds.try_emplace(*name,
+                         static_cast<::Smp::Services::LogMessageKind>(index));
     }
-    // create a ConsoleAppender by default
-    else {
-      _appenders.emplace_back(std::make_unique<ConsoleAppender>(
-          std::string(_basePath) + ".appender.default", properties));
+    _count.store(names.size(), std::memory_order_release);
+  }
+
+private:
+  /// size of the first chunk of names, the size of each next chunk is doubled
+  static constexpr std::size_t firstChunkSize = 64;
+  static constexpr std::size_t chunkCount = 32;
+  using Slot = std::atomic<const std::string *>;
+
+  /// the chunk and the offset in the chunk of an index
+  static std::pair<std::size_t, std::size_t> Locate(std::size_t index) {
+    const auto position = index / firstChunkSize + 1;
+    std::size_t chunk = 0;
+    while ((position >> (chunk + 1)) != 0) {
+      ++chunk;
+    }
+    return {chunk, index - firstChunkSize * ((std::size_t{1} << chunk) - 1)};
+  }
+  void Publish(std::size_t index, const std::string *name) {
+    const auto [chunk, offset] = Locate(index);
+    if (!_chunkStorage[chunk]) {
+      _chunkStorage[chunk] = std::make_unique<Slot[]>(firstChunkSize << chunk);
+      _chunks[chunk].store(_chunkStorage[chunk].get(),
+                           std::memory_order_release);
     }
+    _chunkStorage[chunk][offset].store(name, std::memory_order_release);
+  }
+  ::Smp::Services::LogMessageKind Add(std::string_view name) {
+    const auto index = _count.load(std::memory_order_relaxed);
+    const auto &interned = _names.emplace_back(name);
+    Publish(index, &interned);
+    const auto kind = static_cast<::Smp::Services::LogMessageKind>(index);
+    _kinds.try_emplace(interned, kind);
+    _count.store(index + 1, std::memory_order_release);
+    return kind;
+  }
 
-    // initialize the working thread
-    workingThread = std::thread{&LoggerProcessor::Process, this};
+  mutable std::mutex _mutex;
+  /// stable storage of all the names
+  std::deque<std::string> _names;
+  std::map<std::string, ::Smp::Services::LogMessageKind, std::less<>> _kinds;
+  std::array<std::unique_ptr<Slot[]>, chunkCount> _chunkStorage;
+  std::array<std::atomic<Slot *>, chunkCount> _chunks{};
+  std::atomic<std::size_t> _count{0};
+};
+
+/// Bounded lock free queue of preallocated log records.
+/// Any thread can push and pop records: the logger thread pops the records
+/// to write and the producers pop the oldest records to drop them.
+class LogRecordQueue {
+public:
+  /// the maximal number of records: the records are preallocated
+  static constexpr std::size_t maxCapacity = std::size_t{1} << 16;
+
+  explicit LogRecordQueue(std::size_t capacity)
+      : _mask{Capacity(capacity) - 1},
+        _records{std::make_unique<LogRecord[]>(_mask + 1)} {
+    for (std::size_t i = 0; i <= _mask; ++i) {
+      _records[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// Push a record
+  /// @param fill the function that fills the record
+  /// @return false if the queue is full
+  template <typename F> bool TryPush(F &&fill) {
+    auto pos = _enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+      auto &record = _records[pos & _mask];
+      const auto sequence = record.sequence.load(std::memory_order_acquire);
+      if (sequence == pos) {
+        if (_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          fill(record);
+          record.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (static_cast<std::ptrdiff_t>(sequence - pos) < 0) {
+        return false;
+      } else {
+        pos = _enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
   }
+
+  /// Pop a record
+  /// @param consume the function that reads the record
+  /// @return false if the queue is empty
+  template <typename F> bool TryPop(F &&consume) {
+    auto pos = _dequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+      auto &record = _records[pos & _mask];
+      const auto sequence = record.sequence.load(std::memory_order_acquire);
+      if (sequence == pos + 1) {
+        if (_dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          consume(static_cast<const LogRecord &>(record));
+          record.sequence.store(pos + _mask + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (static_cast<std::ptrdiff_t>(sequence - (pos + 1)) < 0) {
+        return false;
+      } else {
+        pos = _dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  [[nodiscard]] bool Empty() const noexcept {
+    return _dequeuePos.load(std::memory_order_acquire) ==
+           _enqueuePos.load(std::memory_order_acquire);
+  }
+
+private:
+  /// the capacity is rounded to the next power of 2, up to maxCapacity
+  static std::size_t Capacity(std::size_t capacity) noexcept {
+    std::size_t result = 2;
+    while (result < capacity && result < maxCapacity) {
+      result <<= 1;
+    }
+    return result;
+  }
+  const std::size_t _mask;
+  std::unique_ptr<LogRecord[]> _records;
+  alignas(64) std::atomic<std::size_t> _enqueuePos{0};
+  alignas(64) std::atomic<std::size_t> _dequeuePos{0};
+};
+
+class LoggerProcessor {
+public:
+  LoggerProcessor(std::string path, const LogMessageKinds &kinds)
+      : LoggerProcessor(std::move(path), kinds, parseProperties()) {}
   LoggerProcessor(const LoggerProcessor &) = delete;
   LoggerProcessor &operator=(const LoggerProcessor &) = delete;
   LoggerProcessor(LoggerProcessor &&) = delete;
@@ -433,58 +707,207 @@ public:
   ~LoggerProcessor() {
     // terminate the working thread
     Stop();
-    _cv.notify_one();
     if (workingThread.joinable()) {
       workingThread.join();
     }
   }
   void Log(const ::Smp::IObject *sender, ::Smp::String8 msg,
-           const std::string &kind, ::Smp::DateTime zuluTime,
+           ::Smp::Services::LogMessageKind kind, ::Smp::DateTime zuluTime,
            ::Smp::Duration simulationTime, ::Smp::DateTime epochTime,
            ::Smp::Duration missionTime) {
-    Push(sender, msg, kind, zuluTime, simulationTime, epochTime, missionTime);
-    _cv.notify_one();
+    const auto &path = ::Xsmp::Helper::GetCachedPath(sender);
+    const std::string_view message{msg ? msg : ""};
+    const auto fill = [&](LogRecord &record) {
+      record.zuluTime = zuluTime;
+      record.simulationTime = simulationTime;
+      record.epochTime = epochTime;
+      record.missionTime = missionTime;
+      record.kind = kind;
+      record.SetText(path, message);
+    };
+    for (std::size_t retry = 0; !_queue.TryPush(fill); ++retry) {
+      switch (_overflowPolicy) {
+      case OverflowPolicy::Drop:
+        _dropCount.fetch_add(1, std::memory_order_relaxed);
+        Notify();
+        return;
+      case OverflowPolicy::DropOldest:
+        if (_queue.TryPop([](const LogRecord &) {})) {
+          _dropCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        break;
+      case OverflowPolicy::Block:
+        Notify();
+        if (retry < 64) {
+          std::this_thread::yield();
+        } else {
+          std::this_thread::sleep_for(std::chrono::microseconds{50});
+        }
+        break;
+      }
+    }
+    Notify();
   }
 
-private:
-  void Stop() {
-    const std::scoped_lock lck(_mutex);
-    running = false;
-  }
-  void Push(const ::Smp::IObject *sender, ::Smp::String8 msg,
-            const std::string &kind, ::Smp::DateTime zuluTime,
-            ::Smp::Duration simulationTime, ::Smp::DateTime epochTime,
-            ::Smp::Duration missionTime) {
-    const std::scoped_lock lck(_mutex);
-    _logs.push({::Xsmp::Helper::GetPath(sender), msg, kind,
-                Xsmp::DateTime{zuluTime}, Xsmp::Duration{simulationTime},
-                Xsmp::DateTime{epochTime}, Xsmp::Duration{missionTime}});
+  [[nodiscard]] bool Accepts(const std::string &kind) const {
+    return std::any_of(
+        _appenders.begin(), _appenders.end(),
+        [&kind](const auto &appender) { return appender->Accepts(kind); });
   }
-  void Process() {
-    std::unique_lock lck(_mutex);
-    while (running) {
-      while (!_logs.empty()) {
 
-        const auto &log = _logs.front();
-        lck.unlock();
+private:
+  LoggerProcessor(
+      std::string path, const LogMessageKinds &kinds,
+      const std::map<std::string, std::string, std::less<>> &properties)
+      : _path{std::move(path)}, _kinds{kinds},
+        _overflowPolicy{GetOverflowPolicy(properties)},
+        _queue{GetBufferSize(properties)} {
 
-        for (auto const &appender : _appenders) {
-          appender->Append(log);
-        }
-        lck.lock();
-        _logs.pop();
+    if (auto rootLogger =
+            properties.find(std::string(_basePath) + ".rootLogger");
+        rootLogger != properties.end()) {
+      for (const auto &appender : split(rootLogger->second, ',')) {
+        CreateAppender(appender, properties);
       }
-      _cv.wait(lck, [this] { return !running || !_logs.empty(); });
     }
+    // create a ConsoleAppender by default
+    else {
+      _appenders.emplace_back(std::make_unique<ConsoleAppender>(
+          std::string(_basePath) + ".appender.default", properties));
+    }
+
+    // initialize the working thread
+    workingThread = std::thread{&LoggerProcessor::Process, this};
+  }
 
+  void Stop() {
+    {
+      const std::scoped_lock lck(_mutex);
+      running = false;
+    }
+    _cv.notify_one();
+  }
+  /// wake up the working thread if it waits for records
+  void Notify() {
+    // pairs with the fence of Process(): either the working thread sees the
+    // record or the producer sees that it waits
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiting.load(std::memory_order_relaxed)) {
+      const std::scoped_lock lck(_mutex);
+      _cv.notify_one();
+    }
+  }
+  void Append(const LogEntry &entry) {
+    for (auto const &appender : _appenders) {
+      appender->Append(entry);
+    }
+  }
+  void Flush() {
+    for (auto const &appender : _appenders) {
+      appender->Flush();
+    }
+  }
+  /// write the records of the queue
+  /// @return true if at least one record has been written
+  bool ProcessRecords(LogEntry &entry) {
+    bool processed = false;
+    while (_queue.TryPop([this, &entry](const LogRecord &record) {
+      const auto *text = record.Text();
+      entry.sender.assign(text, record.senderSize);
+      entry.msg.assign(text + record.senderSize, record.msgSize);
+      if (const auto *kind = _kinds.Find(record.kind)) {
+        entry.kind.assign(*kind);
+      } else {
+        entry.kind = "<unknown: " + std::to_string(record.kind) + ">";
+      }
+      entry.zuluTime = ::Xsmp::DateTime{record.zuluTime};
+      entry.simulationTime = ::Xsmp::Duration{record.simulationTime};
+      entry.epochTime = ::Xsmp::DateTime{record.epochTime};
+      entry.missionTime = ::Xsmp::Duration{record.missionTime};
+    })) {
+      Append(entry);
+      processed = true;
+    }
+    // report the dropped records
+    if (const auto dropCount = _dropCount.load(std::memory_order_relaxed);
+        dropCount != _reportedDropCount) {
+      Append({_path,
+              std::to_string(dropCount - _reportedDropCount) +
+                  " log message(s) dropped: the log queue is full.",
+              ::Smp::Services::ILogger::LMK_WarningName,
+              ::Xsmp::DateTime::now(), ::Xsmp::Duration{}, ::Xsmp::DateTime{},
+              ::Xsmp::Duration{}});
+      _reportedDropCount = dropCount;
+    }
+    return processed;
+  }
+  void Process() {
+    // reuse the strings of the entry between records
+    LogEntry entry;
+    while (true) {
+      if (ProcessRecords(entry)) {
+        continue;
+      }
+      // the appenders are flushed once the queue is drained, not per record,
+      // and periodically while idle (flush interval, rollover time)
+      Flush();
+      std::unique_lock lck(_mutex);
+      if (!running) {
+        break;
+      }
+      _waiting.store(true, std::memory_order_relaxed);
+      // the producers check _waiting after a push
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (_queue.Empty()) {
+        // the timeout reports the drops of a Drop policy without new logs
+        _cv.wait_for(lck, std::chrono::milliseconds{100});
+      }
+      _waiting.store(false, std::memory_order_relaxed);
+    }
     // process remaining logs if any
-    while (!_logs.empty()) {
-      const auto &log = _logs.front();
-      for (auto const &appender : _appenders) {
-        appender->Append(log);
+    ProcessRecords(entry);
+    Flush();
+  }
+  [[nodiscard]] static OverflowPolicy GetOverflowPolicy(
+      const std::map<std::string, std::string, std::less<>> &properties) {
+    auto policy = properties.find(std::string(_basePath) + ".overflowPolicy");
+    if (policy == properties.end() || policy->second == "block") {
+      return OverflowPolicy::Block;
+    }
+    if (policy->second == "dropOldest") {
+      return OverflowPolicy::DropOldest;
+    }
+    if (policy->second == "drop") {
+      return OverflowPolicy::Drop;
+    }
+    std::cerr << "Overflow policy " << policy->second
+              << " does not exist: only block, dropOldest and drop are "
+                 "supported."
+              << '\n';
+    return OverflowPolicy::Block;
+  }
+  [[nodiscard]] static std::size_t GetBufferSize(
+      const std::map<std::string, std::string, std::less<>> &properties) {
+    constexpr std::size_t defaultBufferSize = 8192;
+    if (auto size = properties.find(std::string(_basePath) + ".bufferSize");
+        size != properties.end()) {
+      try {
+        // a negative value is rejected, not converted to a huge one
+        if (const auto value = std::stoll(size->second); value > 0) {
+          if (static_cast<std::size_t>(value) <= LogRecordQueue::maxCapacity) {
+            return static_cast<std::size_t>(value);
+          }
+          std::cerr << "Log buffer size " << size->second
+                    << " exceeds the maximum of "
+                    << LogRecordQueue::maxCapacity << '\n';
+          return LogRecordQueue::maxCapacity;
+        }
+      } catch (const std::exception &) {
+        // reported below
       }
-      _logs.pop();
+      std::cerr << "Invalid log buffer size: " << size->second << '\n';
     }
+    return defaultBufferSize;
   }
   [[nodiscard]] static std::map<std::string, std::string, std::less<>>
   parseProperties() {
@@ -528,10 +951,13 @@ private:
       } else if (appender->second == "FileAppender") {
         _appenders.emplace_back(
             std::make_unique<FileAppender>(path, properties));
+      } else if (appender->second == "BinaryFileAppender") {
+        _appenders.emplace_back(
+            std::make_unique<BinaryFileAppender>(path, properties));
       } else {
         std::cerr << "Appender " << appender->second
-                  << " does not exist: only ConsoleAppender and FileAppender "
-                     "are supported."
+                  << " does not exist: only ConsoleAppender, FileAppender and "
+                     "BinaryFileAppender are supported."
                   << '\n';
       }
 
@@ -542,9 +968,17 @@ private:
           << path << "=FileAppender' to create a File appender." << '\n';
     }
   }
+  std::string _path;
+  const LogMessageKinds &_kinds;
+  OverflowPolicy _overflowPolicy;
+  LogRecordQueue _queue;
+  std::atomic<std::size_t> _dropCount{0};
+  // only accessed by the working thread
+  std::size_t _reportedDropCount{0};
+  // the mutex and the condition variable are only used to wait for records
   std::mutex _mutex;
   std::condition_variable _cv;
-  std::queue<LogEntry> _logs;
+  std::atomic<bool> _waiting{false};
   std::vector<std::unique_ptr<Appender>> _appenders;
 
   bool running{true};
@@ -554,66 +988,72 @@ private:
 XsmpLogger::XsmpLogger(::Smp::String8 name, ::Smp::String8 description,
                        ::Smp::IComposite *parent, ::Smp::ISimulator *simulator)
     : XsmpLoggerGen::XsmpLoggerGen(name, description, parent, simulator),
-      _processor{std::make_unique<LoggerProcessor>()} {}
+      _logMessageKinds{std::make_unique<LogMessageKinds>()},
+      _processor{std::make_unique<LoggerProcessor>(
+          ::Xsmp::Helper::GetPath(this), *_logMessageKinds)} {
+  UpdateEnabledKinds();
+}
+
+XsmpLogger::~XsmpLogger() noexcept = default;
+
+void XsmpLogger::UpdateEnabledKinds() {
+  for (std::size_t i = 0; i < _enabledKinds.size(); ++i) {
+    const auto *name = _logMessageKinds->Find(
+        static_cast<::Smp::Services::LogMessageKind>(i));
+    _enabledKinds[i].store(!name || _processor->Accepts(*name),
+                           std::memory_order_relaxed);
+  }
+}
+
+bool XsmpLogger::IsLogEnabled(
+    const ::Smp::IObject * /*sender*/,
+    ::Smp::Services::LogMessageKind kind) const noexcept {
+  // the index is a direct cast from ::Smp::Services::LogMessageKind to
+  // ::Smp::UInt32
+  auto index = static_cast<::Smp::UInt32>(kind);
+  return index >= _enabledKinds.size() ||
+         _enabledKinds[index].load(std::memory_order_relaxed);
+}
 
 ::Smp::Services::LogMessageKind
 XsmpLogger::QueryLogMessageKind(::Smp::String8 messageKindName) {
-  const std::scoped_lock lck{_mutex};
-  // this implementation is not very efficient.
-  // we do not expect to call this method too often and to have many different
-  // kinds of msg
-
-  auto msgKindAccess = _logMessageKinds.read();
-  if (auto it = std::find(msgKindAccess.get().begin(),
-                          msgKindAccess.get().end(), messageKindName);
-      it != msgKindAccess.get().end()) {
-    return static_cast<::Smp::Services::LogMessageKind>(
-        it - msgKindAccess.get().begin());
-  }
-  // release read access
-  msgKindAccess.unlock();
-  // create write access
-  auto msgKindAccessWrite = _logMessageKinds.write();
-  // the kind is a direct cast from UInt32 to ::Smp::Services::LogMessageKind
-  auto kind = static_cast<::Smp::Services::LogMessageKind>(
-      msgKindAccessWrite.get().size());
-  msgKindAccessWrite.get().emplace_back(messageKindName);
+  const std::string name{messageKindName ? messageKindName : ""};
+  const auto kind = _logMessageKinds->Query(name);
+  if (auto index = static_cast<::Smp::UInt32>(kind);
+      index < _enabledKinds.size()) {
+    _enabledKinds[index].store(_processor->Accepts(name),
+                               std::memory_order_relaxed);
+  }
   return kind;
 }
 
 void XsmpLogger::Log(const ::Smp::IObject *sender, ::Smp::String8 message,
                      ::Smp::Services::LogMessageKind kind) {
-  const std::scoped_lock lck{_mutex};
-
-  // the index is a direct cast from ::Smp::Services::LogMessageKind to
-  // ::Smp::UInt32
-  auto index = static_cast<::Smp::UInt32>(kind);
-  auto msgKindAccess = _logMessageKinds.read();
-  const auto &msgKind = index < msgKindAccess.get().size()
-                            ? msgKindAccess.get()[index]
-                            : "<unknown: " + std::to_string(kind) + ">";
-  msgKindAccess.unlock();
-
+  if (!IsLogEnabled(sender, kind)) {
+    return;
+  }
   if (GetSimulator() && GetSimulator()->GetTimeKeeper()) {
     auto const *tk = GetSimulator()->GetTimeKeeper();
-    _processor->Log(sender, message, msgKind, tk->GetZuluTime(),
+    _processor->Log(sender, message, kind, tk->GetZuluTime(),
                     tk->GetSimulationTime(), tk->GetEpochTime(),
                     tk->GetMissionTime());
   } else {
-    _processor->Log(sender, message, msgKind,
+    _processor->Log(sender, message, kind,
                     static_cast<::Smp::DateTime>(::Xsmp::DateTime::now()), 0, 0,
                     0);
   }
 }
 
 void XsmpLogger::Restore(::Smp::IStorageReader *reader) {
-  ::Xsmp::Persist::Restore(GetSimulator(), this, reader,
-                           _logMessageKinds.write().get());
+  std::vector<std::string> names;
+  ::Xsmp::Persist::Restore(GetSimulator(), this, reader, names);
+  _logMessageKinds->SetNames(names);
+  UpdateEnabledKinds();
 }
 
 void XsmpLogger::Store(::Smp::IStorageWriter *writer) {
   ::Xsmp::Persist::Store(GetSimulator(), this, writer,
-                         _logMessageKinds.read().get());
+                         _logMessageKinds->GetNames());
 }
 
 } // namespace Xsmp::Services
@@ -17,12 +17,12 @@
 
 #include <Smp/PrimitiveTypes.h>
 #include <Smp/Services/LogMessageKind.h>
+#include <Xsmp/Helper.h>
 #include <Xsmp/Services/XsmpLoggerGen.h>
-#include <Xsmp/ThreadSafeData.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <memory>
-#include <mutex>
-#include <string>
-#include <vector>
 
 // ----------------------------------------------------------------------------
 // ------------------------ Types and Interfaces ------------------------
@@ -31,9 +31,12 @@
 namespace Xsmp::Services {
 
 class LoggerProcessor;
+class LogMessageKinds;
 /// This class is thread safe: it is possible to QueryLogMessageKind and Log at
-/// any time
-class XsmpLogger final : public XsmpLoggerGen {
+/// any time.
+/// Log does not take any lock: the kinds are interned and only their
+/// identifier is queued to the logger thread.
+class XsmpLogger final : public XsmpLoggerGen, public ::Xsmp::ILogFilter {
 public:
   // ------------------------------------------------------------------------------------
   // -------------------------- Constructors/Destructor
@@ -48,7 +51,7 @@ public:
              ::Smp::IComposite *parent, ::Smp::ISimulator *simulator);
 
   /// Virtual destructor to release memory.
-  ~XsmpLogger() noexcept override = default;
+  ~XsmpLogger() noexcept override;
 
   /// Return identifier of log message kind by name.
   ///
@@ -69,6 +72,16 @@ public:
   void Log(const ::Smp::IObject *sender, ::Smp::String8 message,
            ::Smp::Services::LogMessageKind kind = 0) override;
 
+  /// Check whether a message of a given kind is accepted by at least one
+  /// appender.
+  /// This check is lock free: a disabled kind costs a single atomic load.
+  /// @param   sender Object that would send the message.
+  /// @param   kind Kind of message.
+  /// @return  False if all appenders discard the message, true otherwise.
+  [[nodiscard]] bool
+  IsLogEnabled(const ::Smp::IObject *sender,
+               ::Smp::Services::LogMessageKind kind) const noexcept override;
+
   void Restore(::Smp::IStorageReader *reader) override;
 
   void Store(::Smp::IStorageWriter *writer) override;
@@ -76,12 +89,14 @@ public:
 private:
   friend class ::Xsmp::Component::Helper;
 
-  // init pre-defined kinds: keep ordered
-  Xsmp::ThreadSafeData<std::vector<std::string>> _logMessageKinds{
-      std::vector<std::string>{LMK_InformationName, LMK_EventName,
-                               LMK_WarningName, LMK_ErrorName, LMK_DebugName}};
-  std::mutex _mutex;
+  // must outlive the processor that reads the kind names
+  std::unique_ptr<LogMessageKinds> _logMessageKinds;
   std::unique_ptr<LoggerProcessor> _processor;
+
+  // enabled state of the first kinds, the other kinds are always enabled
+  static constexpr std::size_t _filteredKindCount = 64;
+  std::array<std::atomic<bool>, _filteredKindCount> _enabledKinds{};
+  void UpdateEnabledKinds();
 };
 } // namespace Xsmp::Services
 
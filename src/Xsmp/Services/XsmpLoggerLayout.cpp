@@ -0,0 +1,505 @@
+// Copyright 2023 THALES ALENIA SPACE FRANCE. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Smp/PrimitiveTypes.h>
+#include <Xsmp/DateTime.h>
+#include <Xsmp/Duration.h>
+#include <Xsmp/Services/XsmpLoggerLayout.h>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Xsmp::Services {
+
+namespace {
+template <typename T> void WriteValue(std::ostream &stream, const T &value) {
+  stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+template <typename T> bool ReadValue(std::istream &stream, T &value) {
+  return static_cast<bool>(
+      stream.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+bool ReadString(std::istream &stream, std::string &str) {
+  std::uint32_t size = 0;
+  if (!ReadValue(stream, size)) {
+    return false;
+  }
+  str.resize(size);
+  return static_cast<bool>(stream.read(str.data(), size));
+}
+void WriteString(std::ostream &stream, std::string_view str) {
+  WriteValue(stream, static_cast<std::uint32_t>(str.size()));
+  stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+constexpr ::Smp::Int64 nanosecondsPerSecond = 1'000'000'000;
+constexpr ::Smp::Int64 secondsPerDay = 86'400;
+
+void AppendInteger(std::string &buffer, ::Smp::Int64 value) {
+  std::array<char, 24> digits{};
+  const auto result =
+      std::to_chars(digits.data(), digits.data() + digits.size(), value);
+  buffer.append(digits.data(), result.ptr);
+}
+
+/// Append an unsigned value on a fixed number of digits
+template <typename T>
+void AppendDigits(char *output, T value, std::size_t width) {
+  for (auto i = width; i > 0; --i) {
+    output[i - 1] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+void AppendFraction(std::string &buffer, std::uint64_t nanoseconds) {
+  std::array<char, 10> fraction{'.'};
+  AppendDigits(fraction.data() + 1, nanoseconds, 9);
+  buffer.append(fraction.data(), fraction.size());
+}
+
+/// Text of the "%F %T" format of a date, without the fractional seconds
+/// It is cached per thread and computed again only when the second changes.
+std::string_view FormatSecond(::Smp::Int64 seconds) {
+  thread_local ::Smp::Int64 cachedSeconds =
+      std::numeric_limits<::Smp::Int64>::min();
+  thread_local std::array<char, 19> text{};
+  if (seconds == cachedSeconds) {
+    return {text.data(), text.size()};
+  }
+  cachedSeconds = seconds;
+  auto days = seconds / secondsPerDay;
+  auto secondOfDay = seconds % secondsPerDay;
+  if (secondOfDay < 0) {
+    secondOfDay += secondsPerDay;
+    --days;
+  }
+  // civil date from days since 1970-01-01 (H. Hinnant algorithm)
+  days += 719'468;
+  const auto era = (days >= 0 ? days : days - 146'096) / 146'097;
+  const auto dayOfEra = static_cast<std::uint32_t>(days - era * 146'097);
+  const auto yearOfEra =
+      (dayOfEra - dayOfEra / 1460 + dayOfEra / 36'524 - dayOfEra / 146'096) /
+      365;
+  const auto dayOfYear =
+      dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  const auto shiftedMonth = (5 * dayOfYear + 2) / 153;
+  const auto day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+  const auto month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+  const auto year = static_cast<::Smp::Int64>(yearOfEra) + era * 400 +
+                    (month <= 2 ? 1 : 0);
+
+  AppendDigits(text.data(), year, 4);
+  text[4] = '-';
+  AppendDigits(text.data() + 5, month, 2);
+  text[7] = '-';
+  AppendDigits(text.data() + 8, day, 2);
+  text[10] = ' ';
+  AppendDigits(text.data() + 11, secondOfDay / 3600, 2);
+  text[13] = ':';
+  AppendDigits(text.data() + 14, secondOfDay / 60 % 60, 2);
+  text[16] = ':';
+  AppendDigits(text.data() + 17, secondOfDay % 60, 2);
+  return {text.data(), text.size()};
+}
+
+template <typename T>
+void AppendCustom(std::string &buffer, const T &time, const std::string &fmt) {
+  thread_local std::ostringstream stream;
+  stream.str({});
+  stream.clear();
+  time.to_stream(stream, fmt);
+  buffer += stream.str();
+}
+} // namespace
+
+std::string unescape(std::string_view str) {
+  std::string result;
+  result.reserve(str.size());
+  auto it = str.begin();
+  while (it != str.end()) {
+    if (*it == '\\') {
+      if (++it != str.end()) {
+        switch (*it) {
+        case '\'':
+          result += '\'';
+          break;
+        case '"':
+          result += '\"';
+          break;
+        case '?':
+          result += '\?';
+          break;
+        case '\\':
+          result += '\\';
+          break;
+        case 'a':
+          result += '\a';
+          break;
+        case 'b':
+          result += '\b';
+          break;
+        case 'f':
+          result += '\f';
+          break;
+        case 'n':
+          result += '\n';
+          break;
+        case 'r':
+          result += '\r';
+          break;
+        case 't':
+          result += '\t';
+          break;
+        case 'v':
+          result += '\v';
+          break;
+        default:
+          result += *it;
+          break;
+        }
+        ++it;
+      }
+      continue;
+    }
+    result += *it;
+
+    ++it;
+  }
+  return result;
+}
+
+void Layout::Append(std::ostream &stream, const LogEntry &entry) const {
+  // reuse the allocated buffer between the entries
+  thread_local std::string buffer;
+  buffer.clear();
+  Format(buffer, entry);
+  stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+PatternLayout::PatternLayout(std::string pattern)
+    : _operations{Compile(pattern)} {}
+
+PatternLayout::PatternLayout(
+    const std::string &path,
+    const std::map<std::string, std::string, std::less<>> &properties)
+    : _operations{Compile(ComputePatternLayout(path, properties))} {}
+
+std::string PatternLayout::ComputePatternLayout(
+    const std::string &path,
+    const std::map<std::string, std::string, std::less<>>
+        &properties) noexcept {
+
+  if (auto pattern = properties.find(path + ".conversionPattern");
+      pattern != properties.end()) {
+    /*
+     *  %p Output the Path of the sender IObject
+     *  %k Output the message kind name
+     *  %m Output the message
+     *  %d Output the Date of the msg
+     * %S Output the Simulation Time
+     * %E Output the epoch time
+     * %M Output the mission time
+     * %n Output std::endl
+     * %t Output \t
+     * %% Output a single %
+     */
+    return unescape(pattern->second);
+  }
+  // use default pattern
+  return defaultPattern;
+}
+
+std::vector<PatternLayout::Operation>
+PatternLayout::Compile(std::string_view pattern) {
+  using Kind = Operation::Kind;
+  using TimeFormat = Operation::TimeFormat;
+  std::vector<Operation> operations;
+  const auto literal = [&operations](std::string_view text) {
+    if (operations.empty() || operations.back().kind != Kind::Literal) {
+      operations.push_back({Kind::Literal});
+    }
+    operations.back().text += text;
+  };
+  const auto time = [&operations, &pattern](Kind kind, std::size_t &pos) {
+    Operation operation{kind};
+    // optional format between braces
+    if (pos + 1 < pattern.size() && pattern[pos + 1] == '{') {
+      if (const auto end = pattern.find('}', pos + 2);
+          end != std::string_view::npos) {
+        operation.text = pattern.substr(pos + 2, end - pos - 2);
+        pos = end;
+        if (operation.text == "%F %T") {
+          operation.format = TimeFormat::DateTime;
+        } else if (operation.text == "%F") {
+          operation.format = TimeFormat::Date;
+        } else if (operation.text == "%T") {
+          operation.format = TimeFormat::Time;
+        } else if (!operation.text.empty()) {
+          operation.format = TimeFormat::Custom;
+        }
+      }
+    }
+    operations.push_back(std::move(operation));
+  };
+
+  for (std::size_t pos = 0; pos < pattern.size(); ++pos) {
+    if (pattern[pos] != '%') {
+      literal(pattern.substr(pos, 1));
+      continue;
+    }
+    if (++pos == pattern.size()) {
+      literal("%");
+      break;
+    }
+    switch (pattern[pos]) {
+    case 'p':
+      operations.push_back({Kind::Sender});
+      break;
+    case 'k':
+      operations.push_back({Kind::MessageKind});
+      break;
+    case 'm':
+      operations.push_back({Kind::Message});
+      break;
+    case 'd':
+      time(Kind::ZuluTime, pos);
+      break;
+    case 'S':
+      time(Kind::SimulationTime, pos);
+      break;
+    case 'E':
+      time(Kind::EpochTime, pos);
+      break;
+    case 'M':
+      time(Kind::MissionTime, pos);
+      break;
+    case 't':
+      literal("\t");
+      break;
+    case 'n':
+      literal("\n");
+      break;
+    case '%':
+      literal("%");
+      break;
+    default:
+      literal(pattern.substr(pos - 1, 2));
+      break;
+    }
+  }
+  return operations;
+}
+
+void PatternLayout::Format(std::string &buffer, const LogEntry &entry) const {
+  using Kind = Operation::Kind;
+  for (const auto &operation : _operations) {
+    switch (operation.kind) {
+    case Kind::Literal:
+      buffer += operation.text;
+      break;
+    case Kind::Sender:
+      buffer += entry.sender;
+      break;
+    case Kind::MessageKind:
+      buffer += entry.kind;
+      break;
+    case Kind::Message:
+      buffer += entry.msg;
+      break;
+    case Kind::ZuluTime:
+      AppendTime(buffer, entry.zuluTime, operation);
+      break;
+    case Kind::SimulationTime:
+      AppendTime(buffer, entry.simulationTime, operation);
+      break;
+    case Kind::EpochTime:
+      AppendTime(buffer, entry.epochTime, operation);
+      break;
+    case Kind::MissionTime:
+      AppendTime(buffer, entry.missionTime, operation);
+      break;
+    }
+  }
+}
+
+void PatternLayout::AppendTime(std::string &buffer,
+                               const ::Xsmp::DateTime &time,
+                               const Operation &operation) {
+  using TimeFormat = Operation::TimeFormat;
+  if (operation.format == TimeFormat::Nanoseconds) {
+    AppendInteger(buffer, static_cast<::Smp::DateTime>(time));
+    return;
+  }
+  if (operation.format == TimeFormat::Custom) {
+    AppendCustom(buffer, time, operation.text);
+    return;
+  }
+  const auto nanoseconds = static_cast<::Xsmp::DateTime::time_point>(time)
+                               .time_since_epoch()
+                               .count();
+  auto seconds = nanoseconds / nanosecondsPerSecond;
+  auto fraction = nanoseconds % nanosecondsPerSecond;
+  if (fraction < 0) {
+    fraction += nanosecondsPerSecond;
+    --seconds;
+  }
+  const auto text = FormatSecond(seconds);
+  switch (operation.format) {
+  case TimeFormat::Date:
+    buffer += text.substr(0, 10);
+    break;
+  case TimeFormat::Time:
+    buffer += text.substr(11);
+    AppendFraction(buffer, static_cast<std::uint64_t>(fraction));
+    break;
+  default:
+    buffer += text;
+    AppendFraction(buffer, static_cast<std::uint64_t>(fraction));
+    break;
+  }
+}
+
+void PatternLayout::AppendTime(std::string &buffer,
+                               const ::Xsmp::Duration &time,
+                               const Operation &operation) {
+  using TimeFormat = Operation::TimeFormat;
+  const auto nanoseconds = static_cast<::Smp::Duration>(time);
+  if (operation.format == TimeFormat::Nanoseconds) {
+    AppendInteger(buffer, nanoseconds);
+    return;
+  }
+  // a date is meaningless for a duration: let to_stream() handle it
+  if (operation.format != TimeFormat::Time) {
+    AppendCustom(buffer, time, operation.text);
+    return;
+  }
+  // [-]HH:MM:SS.nnnnnnnnn, with at least 2 digits for the hours
+  if (nanoseconds < 0) {
+    buffer += '-';
+  }
+  const auto magnitude =
+      nanoseconds < 0 ? 0 - static_cast<std::uint64_t>(nanoseconds)
+                      : static_cast<std::uint64_t>(nanoseconds);
+  const auto seconds = magnitude / nanosecondsPerSecond;
+  if (const auto hours = seconds / 3600; hours < 10) {
+    buffer += '0';
+    buffer += static_cast<char>('0' + hours);
+  } else {
+    AppendInteger(buffer, static_cast<::Smp::Int64>(hours));
+  }
+  std::array<char, 6> minutesSeconds{':', '0', '0', ':', '0', '0'};
+  AppendDigits(minutesSeconds.data() + 1, seconds / 60 % 60, 2);
+  AppendDigits(minutesSeconds.data() + 4, seconds % 60, 2);
+  buffer.append(minutesSeconds.data(), minutesSeconds.size());
+  AppendFraction(buffer, magnitude % nanosecondsPerSecond);
+}
+
+BinaryLogWriter::BinaryLogWriter(const std::string &fileName)
+    : _stream{fileName, std::ios::binary | std::ios::trunc} {
+  _stream.write(magic.data(), static_cast<std::streamsize>(magic.size()));
+}
+
+std::uint32_t BinaryLogWriter::Intern(const std::string &str) {
+  if (auto it = _strings.find(str); it != _strings.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<std::uint32_t>(_strings.size());
+  _strings.try_emplace(str, id);
+  _stream.put('S');
+  WriteValue(_stream, id);
+  WriteString(_stream, str);
+  return id;
+}
+
+void BinaryLogWriter::Write(const LogEntry &entry) {
+  const auto senderId = Intern(entry.sender);
+  const auto kindId = Intern(entry.kind);
+  _stream.put('E');
+  WriteValue(_stream, static_cast<::Smp::DateTime>(entry.zuluTime));
+  WriteValue(_stream, static_cast<::Smp::Duration>(entry.simulationTime));
+  WriteValue(_stream, static_cast<::Smp::DateTime>(entry.epochTime));
+  WriteValue(_stream, static_cast<::Smp::Duration>(entry.missionTime));
+  WriteValue(_stream, senderId);
+  WriteValue(_stream, kindId);
+  WriteString(_stream, entry.msg);
+}
+
+void BinaryLogWriter::Flush() { _stream.flush(); }
+
+BinaryLogReader::BinaryLogReader(const std::string &fileName)
+    : _stream{fileName, std::ios::binary} {
+  std::string header(BinaryLogWriter::magic.size(), '\0');
+  _valid = _stream.read(header.data(),
+                        static_cast<std::streamsize>(header.size())) &&
+           header == BinaryLogWriter::magic;
+}
+
+bool BinaryLogReader::Read(LogEntry &entry) {
+  if (!_valid) {
+    return false;
+  }
+  for (char type = 0; _stream.get(type);) {
+    if (type == 'S') {
+      std::uint32_t id = 0;
+      std::string str;
+      if (!ReadValue(_stream, id) || !ReadString(_stream, str)) {
+        return false;
+      }
+      if (id >= _strings.size()) {
+        _strings.resize(id + 1);
+      }
+      _strings[id] = std::move(str);
+    } else if (type == 'E') {
+      ::Smp::DateTime zuluTime = 0;
+      ::Smp::Duration simulationTime = 0;
+      ::Smp::DateTime epochTime = 0;
+      ::Smp::Duration missionTime = 0;
+      std::uint32_t senderId = 0;
+      std::uint32_t kindId = 0;
+      if (!ReadValue(_stream, zuluTime) ||
+          !ReadValue(_stream, simulationTime) ||
+          !ReadValue(_stream, epochTime) || !ReadValue(_stream, missionTime) ||
+          !ReadValue(_stream, senderId) || !ReadValue(_stream, kindId) ||
+          !ReadString(_stream, entry.msg) || senderId >= _strings.size() ||
+          kindId >= _strings.size()) {
+        return false;
+      }
+      entry.sender = _strings[senderId];
+      entry.kind = _strings[kindId];
+      entry.zuluTime = ::Xsmp::DateTime{zuluTime};
+      entry.simulationTime = ::Xsmp::Duration{simulationTime};
+      entry.epochTime = ::Xsmp::DateTime{epochTime};
+      entry.missionTime = ::Xsmp::Duration{missionTime};
+      return true;
+    } else {
+      return false;
+    }
+  }
+  return false;
+}
+
+} // namespace Xsmp::Services
@@ -0,0 +1,210 @@
+// Copyright 2023 THALES ALENIA SPACE FRANCE. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XSMP_SERVICES_XSMPLOGGERLAYOUT_H_
+#define XSMP_SERVICES_XSMPLOGGERLAYOUT_H_
+
+#include <Xsmp/DateTime.h>
+#include <Xsmp/Duration.h>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Xsmp::Services {
+
+/// A log message with its sender path, kind name and times.
+struct LogEntry {
+  std::string sender;
+  std::string msg;
+  std::string kind;
+  ::Xsmp::DateTime zuluTime;
+  ::Xsmp::Duration simulationTime;
+  ::Xsmp::DateTime epochTime;
+  ::Xsmp::Duration missionTime;
+};
+
+/// Replace the C escape sequences of a string by their characters.
+/// @param str The string to unescape.
+/// @return The unescaped string.
+std::string unescape(std::string_view str);
+
+/// Text layout of the log entries.
+class Layout {
+public:
+  Layout() = default;
+  Layout(const Layout &) = delete;
+  Layout(Layout &&) = delete;
+  Layout &operator=(const Layout &) = delete;
+  Layout &operator=(Layout &&) = delete;
+  virtual ~Layout() noexcept = default;
+
+  /// Format a log entry.
+  /// @param buffer The buffer to append the formatted entry to.
+  /// @param entry The log entry.
+  virtual void Format(std::string &buffer, const LogEntry &entry) const = 0;
+
+  /// Write a formatted log entry to a stream, without flushing it.
+  /// @param stream The output stream.
+  /// @param entry The log entry.
+  void Append(std::ostream &stream, const LogEntry &entry) const;
+};
+
+/// Layout defined by a conversion pattern.
+/// The pattern is compiled once into a list of operations.
+class PatternLayout final : public Layout {
+public:
+  /// The pattern used when no conversion pattern is configured.
+  static constexpr const char *defaultPattern = "%d{%F %T}%t%S%t%p%t%k%t%m%n";
+
+  /// Create a layout from a conversion pattern.
+  /// @param pattern The conversion pattern, without escape sequences.
+  explicit PatternLayout(std::string pattern);
+
+  /// Create a layout from the "<path>.conversionPattern" property.
+  /// @param path The path of the layout in the properties.
+  /// @param properties The properties of the logger.
+  PatternLayout(
+      const std::string &path,
+      const std::map<std::string, std::string, std::less<>> &properties);
+  ~PatternLayout() noexcept override = default;
+  PatternLayout(const PatternLayout &) = delete;
+  PatternLayout(PatternLayout &&) = delete;
+  PatternLayout &operator=(const PatternLayout &) = delete;
+  PatternLayout &operator=(PatternLayout &&) = delete;
+  void Format(std::string &buffer, const LogEntry &entry) const override;
+
+private:
+  /// A compiled part of the conversion pattern
+  struct Operation {
+    enum class Kind {
+      Literal,
+      Sender,
+      MessageKind,
+      Message,
+      ZuluTime,
+      SimulationTime,
+      EpochTime,
+      MissionTime
+    };
+    enum class TimeFormat {
+      /// no format: the time in nanoseconds
+      Nanoseconds,
+      /// %F %T
+      DateTime,
+      /// %F
+      Date,
+      /// %T
+      Time,
+      /// any other format, written by to_stream()
+      Custom
+    };
+    Kind kind;
+    TimeFormat format{TimeFormat::Nanoseconds};
+    /// the literal text or the custom time format
+    std::string text{};
+  };
+  std::vector<Operation> _operations;
+
+  static std::vector<Operation> Compile(std::string_view pattern);
+  static void AppendTime(std::string &buffer, const ::Xsmp::DateTime &time,
+                         const Operation &operation);
+  static void AppendTime(std::string &buffer, const ::Xsmp::Duration &time,
+                         const Operation &operation);
+  static std::string
+  ComputePatternLayout(const std::string &path,
+                       const std::map<std::string, std::string, std::less<>>
+                           &properties) noexcept;
+};
+
+/// Layout writing the simulation time, the sender, the kind and the message
+/// separated by tabs.
+class SimpleLayout final : public Layout {
+public:
+  SimpleLayout() = default;
+  SimpleLayout(const SimpleLayout &) = delete;
+  SimpleLayout(SimpleLayout &&) = delete;
+  SimpleLayout &operator=(const SimpleLayout &) = delete;
+  SimpleLayout &operator=(SimpleLayout &&) = delete;
+  ~SimpleLayout() noexcept override = default;
+  void Format(std::string &buffer, const LogEntry &entry) const override {
+    _layout.Format(buffer, entry);
+  }
+
+private:
+  PatternLayout _layout{"%S{%T}%t%p%t%k%t%m%n"};
+};
+
+/// Writer of a binary log file.
+/// The file starts with a magic string followed by records:
+/// - 'S' id size bytes: a string of the string table (sender path or kind)
+/// - 'E' zuluTime simulationTime epochTime missionTime senderId kindId
+///   size bytes: a log entry
+///
+/// Times are raw int64, ids and sizes are uint32 in native byte order.
+class BinaryLogWriter {
+public:
+  /// The magic string of a binary log file.
+  static constexpr std::string_view magic{"XSMPLOG1"};
+
+  /// Create a binary log file.
+  /// @param fileName The name of the file.
+  explicit BinaryLogWriter(const std::string &fileName);
+
+  /// Write a log entry, its sender path and kind are written once in the
+  /// string table.
+  /// @param entry The log entry.
+  void Write(const LogEntry &entry);
+
+  /// Flush the file.
+  void Flush();
+
+private:
+  std::ofstream _stream;
+  std::unordered_map<std::string, std::uint32_t> _strings;
+
+  std::uint32_t Intern(const std::string &str);
+};
+
+/// Reader of a binary log file.
+class BinaryLogReader {
+public:
+  /// Open a binary log file.
+  /// @param fileName The name of the file.
+  explicit BinaryLogReader(const std::string &fileName);
+
+  /// Check whether the file is a readable binary log file.
+  /// @return True if the file has been opened and starts with the magic
+  /// string.
+  [[nodiscard]] bool IsValid() const noexcept { return _valid; }
+
+  /// Read the next log entry.
+  /// @param entry The read log entry.
+  /// @return False at the end of the file or on a truncated record.
+  bool Read(LogEntry &entry);
+
+private:
+  std::ifstream _stream;
+  std::vector<std::string> _strings;
+  bool _valid{false};
+};
+
+} // namespace Xsmp::Services
+
+#endif // XSMP_SERVICES_XSMPLOGGERLAYOUT_H_
@@ -25,6 +25,7 @@
 #include <Smp/Services/ITimeKeeper.h>
 #include <Smp/Services/TimeKind.h>
 #include <Smp/SimulatorStateKind.h>
+#include <Xsmp/DateTime.h>
 #include <Xsmp/Exception.h>
 #include <Xsmp/Helper.h>
 #include <Xsmp/Persist.h>
@@ -37,10 +38,33 @@
 #include <Xsmp/Services/XsmpSchedulerGen.h>
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <limits>
 #include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
 
 //  helpers to persist XsmpScheduler::Event type
 namespace Xsmp::Persist {
@@ -66,18 +90,665 @@ template <> struct Helper<::Xsmp::Services::XsmpScheduler::Event> {
 namespace Xsmp::Services {
 static constexpr ::Smp::Duration MaxDuration =
     std::numeric_limits<::Smp::Duration>::max();
+// minimal Zulu time between two overrun warnings
+static constexpr ::Smp::Duration OverrunWarningPeriod = 1'000'000'000;
+
+namespace {
+// the event executed by the current thread of the execution pool
+thread_local ::Smp::Services::EventId parallelEventId = -1;
+
+/// Get the log2 bucket of a duration in microseconds
+/// @param duration the duration in nanoseconds
+/// @param bucketCount the number of buckets
+/// @return 0 for a duration lower than 1us, i for a duration in
+/// [2^(i-1), 2^i) us, bucketCount - 1 for all longer durations.
+std::size_t Log2Bucket(::Smp::Duration duration, std::size_t bucketCount) {
+  const auto microseconds = duration / 1000;
+  std::size_t bucket = 0;
+  while (bucket + 1 < bucketCount && (microseconds >> bucket) > 0) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+template <typename T> void WriteValue(std::ostream &os, T value) {
+  os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool ReadValue(std::istream &is, T &value) {
+  return static_cast<bool>(
+      is.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+/// Write a string in a JSON string literal
+void WriteJsonString(std::ostream &os, std::string_view str) {
+  for (const auto c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      constexpr char digits[] = "0123456789abcdef";
+      os << "\\u00" << digits[(c >> 4) & 0xF] << digits[c & 0xF];
+    } else {
+      os << c;
+    }
+  }
+}
+} // namespace
+
+/// Storages local to each thread accessing an object.
+/// Each storage has a single writer: its thread. The storages are linked in a
+/// lock-free list that the other threads may read, they are deleted with the
+/// object.
+template <typename T> class ThreadStorages {
+public:
+  ThreadStorages() = default;
+  ThreadStorages(const ThreadStorages &) = delete;
+  ThreadStorages &operator=(const ThreadStorages &) = delete;
+
+  ~ThreadStorages() {
+    for (auto *node = _head.load(); node;) {
+      auto *next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  /// @return the storage of the current thread
+  T &Local() {
+    // storages of the current thread by object id (ids are never reused)
+    thread_local std::unordered_map<std::uint64_t, Node *> storages;
+    thread_local std::pair<std::uint64_t, Node *> last{0, nullptr};
+    if (last.first == _id) {
+      return last.second->value;
+    }
+    auto &node = storages[_id];
+    if (!node) {
+      node = new Node;
+      node->next = _head.load(std::memory_order_relaxed);
+      while (!_head.compare_exchange_weak(node->next, node,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+      }
+    }
+    last = {_id, node};
+    return node->value;
+  }
+
+  /// Visit the storages of all the threads
+  template <typename Callback> void ForEach(Callback &&callback) const {
+    for (auto *node = _head.load(std::memory_order_acquire); node;
+         node = node->next) {
+      callback(node->value);
+    }
+  }
+
+private:
+  struct Node {
+    T value;
+    Node *next{};
+  };
+  static inline std::atomic<std::uint64_t> lastId{0};
+  const std::uint64_t _id{++lastId};
+  std::atomic<Node *> _head{nullptr};
+};
+
+/// Profiler of the entry points executed by the scheduler.
+/// Each thread records its executions in its own storage without lock (single
+/// writer), readers merge the storages of all the threads.
+/// A reset only increments a generation: statistics of an older generation are
+/// ignored by the readers and restarted by the writer.
+class EntryPointProfiler {
+public:
+  /// Record an execution of an entry point by the current thread
+  void Record(const ::Smp::IEntryPoint *entryPoint, ::Smp::Duration duration) {
+    auto &entry = _threads.Local().Find(entryPoint);
+    const auto generation = _generation.load(std::memory_order_acquire);
+    if (entry.generation.load(std::memory_order_relaxed) != generation) {
+      entry.count.store(0, std::memory_order_relaxed);
+      entry.total.store(0, std::memory_order_relaxed);
+      for (auto &bucket : entry.histogram) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+      entry.generation.store(generation, std::memory_order_release);
+    }
+    const auto count = entry.count.load(std::memory_order_relaxed) + 1;
+    if (count == 1 || duration < entry.min.load(std::memory_order_relaxed)) {
+      entry.min.store(duration, std::memory_order_relaxed);
+    }
+    if (count == 1 || duration > entry.max.load(std::memory_order_relaxed)) {
+      entry.max.store(duration, std::memory_order_relaxed);
+    }
+    entry.total.store(entry.total.load(std::memory_order_relaxed) + duration,
+                      std::memory_order_relaxed);
+    auto &bucket = entry.histogram[Log2Bucket(duration, histogramSize)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    entry.count.store(count, std::memory_order_release);
+  }
+
+  /// Merge the statistics of all the threads
+  std::vector<XsmpScheduler::ProfileEntry> Collect() const {
+    const auto generation = _generation.load(std::memory_order_acquire);
+    std::vector<XsmpScheduler::ProfileEntry> result;
+    std::unordered_map<const ::Smp::IEntryPoint *, std::size_t> index;
+    _threads.ForEach([&](const ThreadData &data) {
+      for (const auto *chunk = &data.first; chunk;
+           chunk = chunk->next.load(std::memory_order_acquire)) {
+        const auto size = chunk->size.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < size; ++i) {
+          const auto &entry = chunk->entries[i];
+          if (entry.generation.load(std::memory_order_acquire) != generation) {
+            continue;
+          }
+          const auto count = entry.count.load(std::memory_order_acquire);
+          if (count == 0) {
+            continue;
+          }
+          auto [it, inserted] = index.try_emplace(entry.entryPoint,
+                                                  result.size());
+          if (inserted) {
+            result.push_back({entry.entryPoint, entry.path, 0, 0, 0, 0, {}});
+          }
+          auto &profile = result[it->second];
+          const auto min = entry.min.load(std::memory_order_relaxed);
+          const auto max = entry.max.load(std::memory_order_relaxed);
+          profile.min = profile.count ? std::min(profile.min, min) : min;
+          profile.max = profile.count ? std::max(profile.max, max) : max;
+          profile.count += count;
+          profile.total += entry.total.load(std::memory_order_relaxed);
+          for (std::size_t bucket = 0; bucket < histogramSize; ++bucket) {
+            profile.histogram[bucket] +=
+                entry.histogram[bucket].load(std::memory_order_relaxed);
+          }
+        }
+      }
+    });
+    return result;
+  }
+
+  void Reset() noexcept { ++_generation; }
+
+private:
+  static constexpr std::size_t histogramSize =
+      std::tuple_size_v<decltype(XsmpScheduler::ProfileEntry::histogram)>;
+  static constexpr std::size_t chunkSize = 64;
+
+  struct Entry {
+    const ::Smp::IEntryPoint *entryPoint{};
+    // the entry point may be deleted before the profile is read
+    std::string path;
+    std::atomic<std::uint64_t> generation{0};
+    std::atomic<::Smp::UInt64> count{0};
+    std::atomic<::Smp::Duration> total{0};
+    std::atomic<::Smp::Duration> min{0};
+    std::atomic<::Smp::Duration> max{0};
+    std::array<std::atomic<::Smp::UInt64>, histogramSize> histogram{};
+  };
+  // entries are allocated by chunks to keep their address stable
+  struct Chunk {
+    std::array<Entry, chunkSize> entries;
+    std::atomic<std::size_t> size{0};
+    std::atomic<Chunk *> next{nullptr};
+  };
+  // the storage of a thread
+  struct ThreadData {
+    Chunk first;
+    Chunk *last{&first};
+    std::unordered_map<const ::Smp::IEntryPoint *, Entry *> index;
+
+    ThreadData() = default;
+    ThreadData(const ThreadData &) = delete;
+    ThreadData &operator=(const ThreadData &) = delete;
+    ~ThreadData() {
+      for (auto *chunk = first.next.load(); chunk;) {
+        auto *next = chunk->next.load();
+        delete chunk;
+        chunk = next;
+      }
+    }
+
+    Entry &Find(const ::Smp::IEntryPoint *entryPoint) {
+      if (auto it = index.find(entryPoint); it != index.end()) {
+        return *it->second;
+      }
+      auto size = last->size.load(std::memory_order_relaxed);
+      if (size == chunkSize) {
+        auto *chunk = new Chunk;
+        last->next.store(chunk, std::memory_order_release);
+        last = chunk;
+        size = 0;
+      }
+      auto &entry = last->entries[size];
+      entry.entryPoint = entryPoint;
+      entry.path = ::Xsmp::Helper::GetPath(entryPoint);
+      last->size.store(size + 1, std::memory_order_release);
+      index.emplace(entryPoint, &entry);
+      return entry;
+    }
+  };
+
+  std::atomic<std::uint64_t> _generation{1};
+  ThreadStorages<ThreadData> _threads;
+};
+
+/// Binary recorder of the events executed by the scheduler.
+/// Each thread appends its records to its own ring buffer (single writer, no
+/// lock), a background thread drains the ring buffers into the trace file.
+/// The paths of the entry points are interned: a record only holds the id of
+/// the path, the path itself is written once per trace file.
+///
+/// File format (native byte order): the magic "XSMPTRC1" followed by
+/// - 'P' records: path id (uint32), size (uint32) and characters of a path,
+/// - 'E' records: dispatch sequence number (uint64), simulation time, Zulu
+///   time and event id (int64), path id (uint32) and duration (int64) of an
+///   execution.
+class EventTraceRecorder {
+public:
+  static constexpr char magic[] = "XSMPTRC1";
+  static constexpr std::size_t magicSize = sizeof(magic) - 1;
+
+  EventTraceRecorder() = default;
+  EventTraceRecorder(const EventTraceRecorder &) = delete;
+  EventTraceRecorder &operator=(const EventTraceRecorder &) = delete;
+
+  ~EventTraceRecorder() { Stop(); }
+
+  /// Start a new trace
+  /// @return false if the file cannot be opened
+  bool Start(const std::string &fileName, ::Smp::Duration zuluTime) {
+    Stop();
+    _os.open(fileName, std::ios::binary | std::ios::trunc);
+    if (!_os.good()) {
+      return false;
+    }
+    _os.write(magic, magicSize);
+    {
+      const std::scoped_lock lck{_pathsMutex};
+      _paths.clear();
+      _pathIds.clear();
+      _writtenPaths = 0;
+    }
+    _dropped = 0;
+    _sequence = 0;
+    _zuluOrigin.store(zuluTime, std::memory_order_relaxed);
+    _steadyOrigin.store(std::chrono::steady_clock::now(),
+                        std::memory_order_relaxed);
+    // records of a previous trace still in the ring buffers are ignored, the
+    // writers of the new session see its origins
+    _session.fetch_add(1, std::memory_order_release);
+    _stop = false;
+    _flusher = std::thread{&EventTraceRecorder::Flush, this};
+    _recording.store(true, std::memory_order_release);
+    return true;
+  }
+
+  /// Stop the current trace and write the pending records
+  void Stop() {
+    if (!_flusher.joinable()) {
+      return;
+    }
+    _recording.store(false, std::memory_order_release);
+    {
+      const std::scoped_lock lck{_flushMutex};
+      _stop = true;
+    }
+    _flushCv.notify_one();
+    _flusher.join();
+    Drain();
+    _os.close();
+  }
+
+  bool IsRecording() const noexcept {
+    return _recording.load(std::memory_order_acquire);
+  }
+
+  ::Smp::UInt64 GetDropped() const noexcept { return _dropped; }
+
+  /// @return the sequence number of an execution dispatched by the current
+  /// thread: the records are ordered by dispatch, not by completion
+  std::uint64_t Dispatch() noexcept {
+    return _sequence.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Record an execution by the current thread
+  void Record(std::uint64_t sequence, ::Smp::Services::EventId eventId,
+              const ::Smp::IEntryPoint *entryPoint,
+              ::Smp::Duration simulationTime,
+              std::chrono::steady_clock::time_point start,
+              ::Smp::Duration duration) {
+    auto &data = _threads.Local();
+    const auto session = _session.load(std::memory_order_acquire);
+    if (data.session != session) {
+      data.paths.clear();
+      data.session = session;
+    }
+    auto it = data.paths.find(entryPoint);
+    if (it == data.paths.end()) {
+      it = data.paths.emplace(entryPoint, Intern(entryPoint)).first;
+    }
+    const auto head = data.head.load(std::memory_order_relaxed);
+    const auto used = head - data.tail.load(std::memory_order_acquire);
+    if (used == ringSize) {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    if (used == ringSize / 2) {
+      // wake up the flusher before the ring buffer is full
+      _flushRequested.store(true, std::memory_order_relaxed);
+      _flushCv.notify_one();
+    }
+    data.records[head % ringSize] = {
+        sequence,
+        simulationTime,
+        _zuluOrigin.load(std::memory_order_relaxed) +
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                start - _steadyOrigin.load(std::memory_order_relaxed))
+                .count(),
+        eventId,
+        duration,
+        it->second,
+        session};
+    data.head.store(head + 1, std::memory_order_release);
+  }
+
+private:
+  static constexpr std::size_t ringSize = 1 << 13;
+
+  struct Entry {
+    std::uint64_t sequence;
+    ::Smp::Duration simulationTime;
+    ::Smp::Duration zuluTime;
+    ::Smp::Services::EventId eventId;
+    ::Smp::Duration duration;
+    std::uint32_t path;
+    std::uint32_t session;
+  };
+  // the storage of a thread
+  struct ThreadData {
+    std::array<Entry, ringSize> records;
+    std::atomic<std::size_t> head{0};
+    std::atomic<std::size_t> tail{0};
+    // the path ids known by the thread in the current session
+    std::unordered_map<const ::Smp::IEntryPoint *, std::uint32_t> paths;
+    std::uint32_t session{0};
+  };
+
+  /// @return the id of the path of an entry point
+  std::uint32_t Intern(const ::Smp::IEntryPoint *entryPoint) {
+    const std::scoped_lock lck{_pathsMutex};
+    auto [it, inserted] = _pathIds.try_emplace(
+        entryPoint, static_cast<std::uint32_t>(_paths.size()));
+    if (inserted) {
+      _paths.push_back(::Xsmp::Helper::GetPath(entryPoint));
+    }
+    return it->second;
+  }
+
+  /// Write the records of all the threads in the file
+  void Drain() {
+    const auto session = _session.load(std::memory_order_relaxed);
+    _batch.clear();
+    _threads.ForEach([this, session](ThreadData &data) {
+      const auto head = data.head.load(std::memory_order_acquire);
+      for (auto tail = data.tail.load(std::memory_order_relaxed); tail != head;
+           ++tail) {
+        if (const auto &record = data.records[tail % ringSize];
+            record.session == session) {
+          _batch.push_back(record);
+        }
+      }
+      data.tail.store(head, std::memory_order_release);
+    });
+    {
+      // the paths are interned before their records are published
+      const std::scoped_lock lck{_pathsMutex};
+      for (; _writtenPaths < _paths.size(); ++_writtenPaths) {
+        const auto &path = _paths[_writtenPaths];
+        _os.put('P');
+        WriteValue(_os, static_cast<std::uint32_t>(_writtenPaths));
+        WriteValue(_os, static_cast<std::uint32_t>(path.size()));
+        _os.write(path.data(), static_cast<std::streamsize>(path.size()));
+      }
+    }
+    std::sort(_batch.begin(), _batch.end(),
+              [](const Entry &lhs, const Entry &rhs) {
+                return lhs.sequence < rhs.sequence;
+              });
+    for (const auto &record : _batch) {
+      _os.put('E');
+      WriteValue(_os, record.sequence);
+      WriteValue(_os, record.simulationTime);
+      WriteValue(_os, record.zuluTime);
+      WriteValue(_os, record.eventId);
+      WriteValue(_os, record.path);
+      WriteValue(_os, record.duration);
+    }
+    _os.flush();
+  }
+
+  /// Drain the ring buffers periodically until the trace is stopped
+  void Flush() {
+    std::unique_lock lck{_flushMutex};
+    while (!_stop) {
+      _flushCv.wait_for(lck, std::chrono::milliseconds{10}, [this] {
+        return _stop || _flushRequested.load(std::memory_order_relaxed);
+      });
+      _flushRequested.store(false, std::memory_order_relaxed);
+      lck.unlock();
+      Drain();
+      lck.lock();
+    }
+  }
+
+  ThreadStorages<ThreadData> _threads;
+  std::atomic<bool> _recording{false};
+  std::atomic<std::uint32_t> _session{0};
+  std::atomic<std::uint64_t> _sequence{0};
+  std::atomic<::Smp::UInt64> _dropped{0};
+  std::atomic<::Smp::Duration> _zuluOrigin{0};
+  std::atomic<std::chrono::steady_clock::time_point> _steadyOrigin{};
+
+  std::mutex _pathsMutex;
+  std::vector<std::string> _paths;
+  std::unordered_map<const ::Smp::IEntryPoint *, std::uint32_t> _pathIds;
+  std::size_t _writtenPaths{0};
+
+  std::ofstream _os;
+  std::vector<Entry> _batch;
+  std::thread _flusher;
+  std::mutex _flushMutex;
+  std::condition_variable _flushCv;
+  std::atomic<bool> _flushRequested{false};
+  bool _stop{false};
+};
+
+/// Pool of threads executing a set of independent tasks.
+/// The thread calling Run() takes part in the execution and returns when all
+/// tasks are completed.
+class ExecutionPool {
+public:
+  explicit ExecutionPool(std::size_t count) {
+    for (std::size_t i = 1; i < count; ++i) {
+      _workers.emplace_back(&ExecutionPool::Work, this);
+    }
+  }
+  ExecutionPool(const ExecutionPool &) = delete;
+  ExecutionPool &operator=(const ExecutionPool &) = delete;
+
+  ~ExecutionPool() {
+    {
+      const std::scoped_lock lck{_mutex};
+      _terminate = true;
+    }
+    _cv.notify_all();
+    for (auto &worker : _workers) {
+      worker.join();
+    }
+  }
+
+  /// Return the number of threads, including the calling thread
+  std::size_t size() const noexcept { return _workers.size() + 1; }
+
+  /// Execute task(i) for each i in [0, count) and wait for completion
+  void Run(std::size_t count, const std::function<void(std::size_t)> &task) {
+    {
+      std::unique_lock lck{_mutex};
+      // wait for workers still looking for a task of the previous run
+      _doneCv.wait(lck, [this] { return _active == 0; });
+      _task = &task;
+      _count = count;
+      _next = 0;
+      ++_generation;
+    }
+    _cv.notify_all();
+    Process(task, count);
+
+    std::unique_lock lck{_mutex};
+    _doneCv.wait(lck, [this] { return _active == 0; });
+    _task = nullptr;
+  }
+
+private:
+  void Process(const std::function<void(std::size_t)> &task,
+               std::size_t count) {
+    for (auto index = _next++; index < count; index = _next++) {
+      task(index);
+    }
+  }
+
+  void Work() {
+    std::uint64_t generation = 0;
+    std::unique_lock lck{_mutex};
+    while (true) {
+      _cv.wait(lck, [this, generation] {
+        return _terminate || _generation != generation;
+      });
+      if (_terminate) {
+        return;
+      }
+      generation = _generation;
+      if (!_task) {
+        continue;
+      }
+      const auto *task = _task;
+      const auto count = _count;
+      ++_active;
+      lck.unlock();
+      Process(*task, count);
+      lck.lock();
+      if (--_active == 0) {
+        _doneCv.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::thread> _workers;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::condition_variable _doneCv;
+  const std::function<void(std::size_t)> *_task{};
+  std::size_t _count{};
+  std::atomic<std::size_t> _next{};
+  std::size_t _active{};
+  std::uint64_t _generation{};
+  bool _terminate{};
+};
+
+/// High precision timer of the Zulu thread.
+/// On Linux, waits on a timerfd armed with an absolute CLOCK_REALTIME deadline
+/// and can be interrupted from another thread through an eventfd.
+class ZuluTimer {
+public:
+  ZuluTimer() {
+#if defined(__linux__)
+    _timer = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    _interrupt = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+  }
+  ZuluTimer(const ZuluTimer &) = delete;
+  ZuluTimer &operator=(const ZuluTimer &) = delete;
+
+  ~ZuluTimer() {
+#if defined(__linux__)
+    if (_timer != -1) {
+      close(_timer);
+    }
+    if (_interrupt != -1) {
+      close(_interrupt);
+    }
+#endif
+  }
+
+  /// @return true if the timer can be used on this platform
+  bool IsAvailable() const noexcept { return _timer != -1 && _interrupt != -1; }
+
+  /// Wait until a Zulu time or an interruption
+  /// @param zuluTime the Zulu time to wait for
+  void Wait([[maybe_unused]] ::Smp::DateTime zuluTime) {
+#if defined(__linux__)
+    // remove the default timer slack (50us) of the waiting thread
+    static thread_local const bool slack = prctl(PR_SET_TIMERSLACK, 1UL) == 0;
+    (void)slack;
+    const auto deadline =
+        static_cast<std::chrono::system_clock::time_point>(
+            ::Xsmp::DateTime{zuluTime})
+            .time_since_epoch();
+    const auto seconds =
+        std::chrono::duration_cast<std::chrono::seconds>(deadline);
+    itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(seconds.count());
+    spec.it_value.tv_nsec = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(deadline -
+                                                             seconds)
+            .count());
+    // a deadline in the past expires immediately, a null deadline disarms
+    // the timer
+    if (spec.it_value.tv_sec <= 0 && spec.it_value.tv_nsec <= 0) {
+      spec.it_value.tv_nsec = 1;
+    }
+    timerfd_settime(_timer, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+    std::array<pollfd, 2> fds{pollfd{_timer, POLLIN, 0},
+                              pollfd{_interrupt, POLLIN, 0}};
+    while (poll(fds.data(), fds.size(), -1) == -1 && errno == EINTR) {
+    }
+    // consume the notifications
+    std::uint64_t value = 0;
+    if (fds[0].revents & POLLIN) {
+      [[maybe_unused]] auto ret = read(_timer, &value, sizeof(value));
+    }
+    if (fds[1].revents & POLLIN) {
+      [[maybe_unused]] auto ret = read(_interrupt, &value, sizeof(value));
+    }
+#endif
+  }
+
+  /// Interrupt the current (or the next) call to Wait()
+  void Interrupt() {
+#if defined(__linux__)
+    const std::uint64_t value = 1;
+    [[maybe_unused]] auto ret = write(_interrupt, &value, sizeof(value));
+#endif
+  }
+
+private:
+  int _timer{-1};
+  int _interrupt{-1};
+};
 
 XsmpScheduler::XsmpScheduler(::Smp::String8 name, ::Smp::String8 description,
                              ::Smp::IComposite *parent,
                              ::Smp::ISimulator *simulator)
-    : XsmpSchedulerGen::XsmpSchedulerGen(name, description, parent, simulator) {
+    : XsmpSchedulerGen::XsmpSchedulerGen(name, description, parent, simulator),
+      _zuluTimer{std::make_unique<ZuluTimer>()},
+      _profiler{std::make_unique<EntryPointProfiler>()},
+      _tracer{std::make_unique<EventTraceRecorder>()} {
 
   // post an event to Hold the simulation at the maximal duration
   static constexpr ::Smp::Services::EventId holdId = -2;
-  _events.try_emplace(holdId,
-                      Event{&HoldEvent, MaxDuration, MaxDuration, 0, 0,
-                            ::Smp::Services::TimeKind::TK_SimulationTime});
-  _events_table.try_emplace(MaxDuration, EventList{holdId});
+  Schedule(AllocateSlot(
+      holdId, Event{&HoldEvent, MaxDuration, MaxDuration, 0, 0,
+                    ::Smp::Services::TimeKind::TK_SimulationTime}));
 }
 
 XsmpScheduler::~XsmpScheduler() {
@@ -91,8 +762,11 @@ void XsmpScheduler::DoConnect(const ::Smp::ISimulator *simulator) {
       ::Smp::Services::IEventManager::SMP_EnterExecutingId, &EnterExecuting);
   simulator->GetEventManager()->Subscribe(
       ::Smp::Services::IEventManager::SMP_LeaveExecutingId, &LeaveExecuting);
+  _overrunEventId =
+      simulator->GetEventManager()->QueryEventId(SchedulerOverrunEvent);
 
   _zuluThread = std::thread(&XsmpScheduler::InternalZuluRun, this);
+  ConfigureZuluThread();
 }
 
 void XsmpScheduler::DoDisconnect() {
@@ -105,7 +779,7 @@ void XsmpScheduler::DoDisconnect() {
     }
     _terminate = true;
   }
-  _zuluCv.notify_one();
+  NotifyZuluThread();
   if (_zuluThread.joinable()) {
     _zuluThread.join();
   }
@@ -122,18 +796,873 @@ void XsmpScheduler::SetTargetSpeed(double speed) {
 
 double XsmpScheduler::GetTargetSpeed() const noexcept { return _targetSpeed; }
 
-::Smp::Services::EventId
-XsmpScheduler::AddImmediateEvent(const ::Smp::IEntryPoint *entryPoint) {
+void XsmpScheduler::SetFreeRunning(bool freeRunning) noexcept {
+  _freeRunning = freeRunning;
+}
+
+bool XsmpScheduler::IsFreeRunning() const noexcept { return _freeRunning; }
+
+::Smp::Bool XsmpScheduler::get_FreeRunning() { return IsFreeRunning(); }
 
+void XsmpScheduler::set_FreeRunning(::Smp::Bool value) {
+  SetFreeRunning(value);
+}
+
+void XsmpScheduler::SetTimingWheelTick(::Smp::Duration tick) {
   const std::scoped_lock lck{_eventsMutex};
-  ++_lastEventId;
+  if (tick < 0) {
+    tick = 0;
+  }
+  // move all scheduled events in the new tables
+  std::vector<SlotIndex> slots;
+  slots.reserve(_events.size());
+  for (const auto &[eventId, slot] : _events) {
+    if (IsScheduled(_slots[slot])) {
+      Unschedule(slot);
+      slots.push_back(slot);
+    }
+  }
+  _timingWheel.clear(tick,
+                     GetSimulator()->GetTimeKeeper()->GetSimulationTime());
+  for (const auto slot : slots) {
+    Schedule(slot);
+  }
+}
+
+::Smp::Duration XsmpScheduler::GetTimingWheelTick() const {
+  const std::scoped_lock lck{_eventsMutex};
+  return _timingWheel.tick();
+}
+
+void XsmpScheduler::SetExecutionThreads(std::size_t count) {
+  // the pool is rebuilt by the scheduler thread when no entry point is running
+  _executionThreads = count < 2 ? 0 : count;
+}
+
+void XsmpScheduler::UpdateExecutionPool() {
+  const std::scoped_lock lck{_execMutex};
+  const std::size_t count = _executionThreads;
+  if (count != (_executionPool ? _executionPool->size() : 0)) {
+    _executionPool.reset();
+    if (count) {
+      _executionPool = std::make_unique<ExecutionPool>(count);
+    }
+  }
+}
+
+void XsmpScheduler::SetZuluDispatcherSettings(
+    const ZuluDispatcherSettings &settings) {
+  {
+    const std::scoped_lock lck{_zuluEventsTableMutex};
+    _zuluSettings = settings;
+    if (_zuluSettings.spinWindow < 0) {
+      _zuluSettings.spinWindow = 0;
+    }
+    if (_zuluSettings.highPrecision && !_zuluTimer->IsAvailable()) {
+      GetSimulator()->GetLogger()->Log(
+          this, "High precision Zulu timer is not available on this platform",
+          ::Smp::Services::ILogger::LMK_Warning);
+      _zuluSettings.highPrecision = false;
+    }
+    _zuluHighPrecision = _zuluSettings.highPrecision;
+  }
+  // wake up the zulu thread in both modes
+  _zuluCv.notify_one();
+  _zuluTimer->Interrupt();
+  ConfigureZuluThread();
+}
+
+XsmpScheduler::ZuluDispatcherSettings
+XsmpScheduler::GetZuluDispatcherSettings() const {
+  const std::scoped_lock lck{_zuluEventsTableMutex};
+  return _zuluSettings;
+}
+
+XsmpScheduler::ZuluJitterHistogram
+XsmpScheduler::GetZuluJitterHistogram() const {
+  const std::scoped_lock lck{_zuluEventsTableMutex};
+  return _zuluJitter;
+}
+
+void XsmpScheduler::ResetZuluJitterHistogram() {
+  const std::scoped_lock lck{_zuluEventsTableMutex};
+  _zuluJitter.fill(0);
+}
+
+void XsmpScheduler::NotifyZuluThread() {
+  _zuluCv.notify_one();
+  if (_zuluHighPrecision) {
+    _zuluTimer->Interrupt();
+  }
+}
+
+void XsmpScheduler::ConfigureZuluThread() {
+  int cpu = -1;
+  int priority = 0;
+  {
+    const std::scoped_lock lck{_zuluEventsTableMutex};
+    cpu = _zuluSettings.cpu;
+    priority = _zuluSettings.priority;
+  }
+  if (!_zuluThread.joinable()) {
+    return;
+  }
+  std::string error;
+#if defined(__linux__)
+  if (cpu >= 0) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    if (auto result = pthread_setaffinity_np(_zuluThread.native_handle(),
+                                             sizeof(cpuSet), &cpuSet)) {
+      error = "Cannot pin the Zulu thread on CPU " + std::to_string(cpu) +
+              ": " + std::strerror(result);
+    }
+  }
+  sched_param param{};
+  param.sched_priority = priority;
+  if (auto result = pthread_setschedparam(_zuluThread.native_handle(),
+                                          priority > 0 ? SCHED_FIFO
+                                                       : SCHED_OTHER,
+                                          &param)) {
+    error = "Cannot set the SCHED_FIFO priority of the Zulu thread to " +
+            std::to_string(priority) + ": " + std::strerror(result);
+  }
+#else
+  if (cpu >= 0 || priority > 0) {
+    error = "CPU affinity and priority of the Zulu thread are not supported "
+            "on this platform";
+  }
+#endif
+  if (!error.empty()) {
+    GetSimulator()->GetLogger()->Log(this, error.c_str(),
+                                     ::Smp::Services::ILogger::LMK_Warning);
+  }
+}
+
+void XsmpScheduler::SetProfiling(bool profiling) noexcept {
+  _profiling = profiling;
+}
+
+bool XsmpScheduler::IsProfiling() const noexcept { return _profiling; }
+
+std::vector<XsmpScheduler::ProfileEntry> XsmpScheduler::GetProfile() const {
+  auto profile = _profiler->Collect();
+  std::sort(profile.begin(), profile.end(),
+            [](const ProfileEntry &lhs, const ProfileEntry &rhs) {
+              return lhs.total > rhs.total;
+            });
+  return profile;
+}
+
+void XsmpScheduler::ResetProfile() { _profiler->Reset(); }
+
+void XsmpScheduler::DumpProfile(::Smp::String8 fileName) {
+  const std::string path{fileName ? fileName : ""};
+  std::ofstream os{path};
+  if (!os.good()) {
+    ::Xsmp::Exception::throwException(this, "CannotDumpProfile",
+                                      "Cannot dump the execution profile",
+                                      "Cannot open file: ", path);
+  }
+  const auto profile = GetProfile();
+  const bool json = path.size() >= 5 && path.substr(path.size() - 5) == ".json";
+
+  if (json) {
+    os << "[";
+    for (std::size_t i = 0; i < profile.size(); ++i) {
+      const auto &entry = profile[i];
+      os << (i ? ",\n" : "\n") << R"(  {"entryPoint": ")";
+      WriteJsonString(os, entry.path);
+      os << R"(", "count": )" << entry.count << R"(, "total": )"
+         << entry.total << R"(, "min": )" << entry.min << R"(, "max": )"
+         << entry.max << R"(, "histogram": [)";
+      for (std::size_t bucket = 0; bucket < entry.histogram.size(); ++bucket) {
+        os << (bucket ? ", " : "") << entry.histogram[bucket];
+      }
+      os << "]}";
+    }
+    os << "\n]\n";
+    return;
+  }
+
+  // CSV: durations in nanoseconds, then the number of executions per bucket
+  os << "entryPoint,count,total,min,max,mean";
+  constexpr auto bucketCount =
+      std::tuple_size_v<decltype(ProfileEntry::histogram)>;
+  for (std::size_t bucket = 0; bucket + 1 < bucketCount; ++bucket) {
+    os << ",<" << (std::uint64_t{1} << bucket) << "us";
+  }
+  // the last bucket includes all the longer executions
+  os << ",>=" << (std::uint64_t{1} << (bucketCount - 2)) << "us";
+  os << "\n";
+  for (const auto &entry : profile) {
+    os << entry.path << ',' << entry.count
+       << ',' << entry.total << ',' << entry.min << ',' << entry.max << ','
+       << entry.total / static_cast<::Smp::Duration>(entry.count);
+    for (const auto value : entry.histogram) {
+      os << ',' << value;
+    }
+    os << "\n";
+  }
+}
+
+void XsmpScheduler::StartTrace(::Smp::String8 fileName) {
+  const std::string path{fileName ? fileName : ""};
+  if (!_tracer->Start(path,
+                      GetSimulator()->GetTimeKeeper()->GetZuluTime())) {
+    ::Xsmp::Exception::throwException(this, "CannotStartTrace",
+                                      "Cannot start the event trace",
+                                      "Cannot open file: ", path);
+  }
+}
+
+void XsmpScheduler::StopTrace() { _tracer->Stop(); }
+
+bool XsmpScheduler::IsTracing() const noexcept {
+  return _tracer->IsRecording();
+}
+
+::Smp::UInt64 XsmpScheduler::GetTraceDropCount() const noexcept {
+  return _tracer->GetDropped();
+}
+
+std::vector<XsmpScheduler::TraceRecord>
+XsmpScheduler::ReadTrace(::Smp::String8 fileName) const {
+  const std::string path{fileName ? fileName : ""};
+  std::ifstream is{path, std::ios::binary};
+  std::array<char, EventTraceRecorder::magicSize> magic{};
+  if (!is.read(magic.data(), magic.size()) ||
+      std::string_view{magic.data(), magic.size()} !=
+          EventTraceRecorder::magic) {
+    ::Xsmp::Exception::throwException(this, "CannotReadTrace",
+                                      "Cannot read an event trace",
+                                      "Invalid trace file: ", path);
+  }
+  std::vector<std::string> paths;
+  std::vector<std::pair<std::uint64_t, TraceRecord>> records;
+  for (char tag = 0; is.get(tag);) {
+    bool valid = false;
+    if (tag == 'P') {
+      std::uint32_t id = 0;
+      std::uint32_t size = 0;
+      if (ReadValue(is, id) && ReadValue(is, size) && id == paths.size()) {
+        std::string entryPoint(size, '\0');
+        valid = static_cast<bool>(is.read(entryPoint.data(), size));
+        paths.push_back(std::move(entryPoint));
+      }
+    } else if (tag == 'E') {
+      std::uint64_t sequence = 0;
+      TraceRecord record{};
+      std::uint32_t id = 0;
+      valid = ReadValue(is, sequence) && ReadValue(is, record.simulationTime) &&
+              ReadValue(is, record.zuluTime) && ReadValue(is, record.eventId) &&
+              ReadValue(is, id) && ReadValue(is, record.duration) &&
+              id < paths.size();
+      if (valid) {
+        record.entryPoint = paths[id];
+        records.emplace_back(sequence, std::move(record));
+      }
+    }
+    if (!valid) {
+      ::Xsmp::Exception::throwException(this, "CannotReadTrace",
+                                        "Cannot read an event trace",
+                                        "Corrupted trace file: ", path);
+    }
+  }
+  // the records of the different threads are written by batches
+  std::stable_sort(records.begin(), records.end(),
+                   [](const auto &lhs, const auto &rhs) {
+                     return lhs.first < rhs.first;
+                   });
+  std::vector<TraceRecord> result;
+  result.reserve(records.size());
+  for (auto &record : records) {
+    result.push_back(std::move(record.second));
+  }
+  return result;
+}
+
+::Smp::String8 XsmpScheduler::CompareTrace(::Smp::String8 referenceFileName,
+                                           ::Smp::String8 fileName) {
+  // the events executed at the same simulation time (in parallel or not) are
+  // compared in the order of their ids, the order in which they are
+  // dispatched depends on the threads
+  const auto read = [this](::Smp::String8 path) {
+    auto records = ReadTrace(path);
+    std::stable_sort(records.begin(), records.end(),
+                     [](const TraceRecord &lhs, const TraceRecord &rhs) {
+                       return std::tie(lhs.simulationTime, lhs.eventId) <
+                              std::tie(rhs.simulationTime, rhs.eventId);
+                     });
+    return records;
+  };
+  const auto reference = read(referenceFileName);
+  const auto trace = read(fileName);
+  const auto print = [](std::ostream &os, const TraceRecord &record) {
+    os << "event " << record.eventId << " (" << record.entryPoint << ") at "
+       << record.simulationTime;
+  };
+  std::ostringstream os;
+  const auto size = std::min(reference.size(), trace.size());
+  std::size_t index = 0;
+  while (index < size && reference[index].simulationTime ==
+                             trace[index].simulationTime &&
+         reference[index].eventId == trace[index].eventId &&
+         reference[index].entryPoint == trace[index].entryPoint) {
+    ++index;
+  }
+  if (index < size) {
+    os << "record " << index << ": expected ";
+    print(os, reference[index]);
+    os << ", got ";
+    print(os, trace[index]);
+  } else if (index < reference.size()) {
+    os << "record " << index << ": expected ";
+    print(os, reference[index]);
+    os << ", got the end of the trace";
+  } else if (index < trace.size()) {
+    os << "record " << index << ": expected the end of the trace, got ";
+    print(os, trace[index]);
+  }
+  _traceDivergence = os.str();
+  if (!_traceDivergence.empty()) {
+    const auto message = std::string{"Trace diverges from the reference at "} +
+                         _traceDivergence;
+    GetSimulator()->GetLogger()->Log(this, message.c_str(),
+                                     ::Smp::Services::ILogger::LMK_Warning);
+  }
+  return _traceDivergence.c_str();
+}
+
+double XsmpScheduler::GetLoad() { return _load.GetAverage(); }
+
+double XsmpScheduler::GetSpeed() {
+  const auto average = _speed.GetAverage();
+  return average > 0. ? 1. / average : 0.;
+}
+
+::Smp::Bool XsmpScheduler::get_Profiling() { return IsProfiling(); }
+
+void XsmpScheduler::set_Profiling(::Smp::Bool value) { SetProfiling(value); }
+
+::Smp::Float64 XsmpScheduler::get_Load() { return GetLoad(); }
+
+::Smp::Float64 XsmpScheduler::get_Speed() { return GetSpeed(); }
+
+void XsmpScheduler::SetOverrunPolicy(OverrunPolicy policy) noexcept {
+  _overrunPolicy = policy;
+}
+
+XsmpScheduler::OverrunPolicy XsmpScheduler::GetOverrunPolicy() const noexcept {
+  return _overrunPolicy;
+}
+
+void XsmpScheduler::SetOverrunTolerance(::Smp::Duration tolerance) noexcept {
+  _overrunTolerance = tolerance < 0 ? 0 : tolerance;
+}
+
+::Smp::Duration XsmpScheduler::GetOverrunTolerance() const noexcept {
+  return _overrunTolerance;
+}
+
+::Smp::Int64 XsmpScheduler::GetOverrunCount() const noexcept {
+  return _overrunCount;
+}
+
+::Smp::Duration XsmpScheduler::GetMaxLateness() const noexcept {
+  return _maxLateness;
+}
+
+void XsmpScheduler::ResetOverruns() noexcept {
+  _overrunCount = 0;
+  _maxLateness = 0;
+}
+
+::Smp::Int32 XsmpScheduler::get_OverrunPolicy() {
+  return static_cast<::Smp::Int32>(GetOverrunPolicy());
+}
+
+void XsmpScheduler::set_OverrunPolicy(::Smp::Int32 value) {
+  if (value < static_cast<::Smp::Int32>(OverrunPolicy::CatchUp) ||
+      value > static_cast<::Smp::Int32>(OverrunPolicy::Emit)) {
+    ::Xsmp::Exception::throwInvalidParameterValue(
+        this, "OverrunPolicy", {::Smp::PrimitiveTypeKind::PTK_Int32, value});
+  }
+  SetOverrunPolicy(static_cast<OverrunPolicy>(value));
+}
+
+::Smp::Duration XsmpScheduler::get_OverrunTolerance() {
+  return GetOverrunTolerance();
+}
+
+void XsmpScheduler::set_OverrunTolerance(::Smp::Duration value) {
+  SetOverrunTolerance(value);
+}
+
+::Smp::Int64 XsmpScheduler::get_OverrunCount() { return GetOverrunCount(); }
+
+::Smp::Duration XsmpScheduler::get_MaxLateness() { return GetMaxLateness(); }
+
+bool XsmpScheduler::HandleOverrun(::Smp::Duration lateness,
+                                  ::Smp::Duration &delay) {
+  ++_overrunCount;
+  // only the scheduler thread updates the worst lateness
+  if (lateness > _maxLateness) {
+    _maxLateness = lateness;
+  }
+  ++_unreportedOverruns;
+  _unreportedLateness = std::max(_unreportedLateness, lateness);
+  if (const auto now = GetSimulator()->GetTimeKeeper()->GetZuluTime();
+      now - _overrunWarningTime >= OverrunWarningPeriod) {
+    if (auto *logger = GetSimulator()->GetLogger();
+        ::Xsmp::Helper::IsLogEnabled(logger, this,
+                                     ::Smp::Services::ILogger::LMK_Warning)) {
+      const auto message =
+          _unreportedOverruns == 1
+              ? "Time step missed its Zulu deadline by " +
+                    std::to_string(lateness / 1000) + "us"
+              : std::to_string(_unreportedOverruns) +
+                    " time steps missed their Zulu deadline since the last "
+                    "warning, the worst by " +
+                    std::to_string(_unreportedLateness / 1000) + "us";
+      logger->Log(this, message.c_str(),
+                  ::Smp::Services::ILogger::LMK_Warning);
+    }
+    _unreportedOverruns = 0;
+    _unreportedLateness = 0;
+    _overrunWarningTime = now;
+  }
+
+  switch (_overrunPolicy) {
+  case OverrunPolicy::SkipToNow:
+    delay = 0;
+    break;
+  case OverrunPolicy::Hold:
+    GetSimulator()->Hold(true);
+    return false;
+  case OverrunPolicy::Emit:
+    GetSimulator()->GetEventManager()->Emit(_overrunEventId);
+    break;
+  case OverrunPolicy::CatchUp:
+    break;
+  }
+  return true;
+}
+
+std::vector<XsmpScheduler::LookaheadEntry>
+XsmpScheduler::GetNextEvents(std::size_t count) {
+  std::vector<LookaheadEntry> entries;
+  const std::scoped_lock lck{_eventsMutex};
+  // the immediate events are executed first, then the immediate events not
+  // yet collected (the queue is only drained with the mutex locked)
+  const auto now = GetSimulator()->GetTimeKeeper()->GetSimulationTime();
+  for (auto it = _immediate_events.begin();
+       it != _immediate_events.end() && entries.size() < count; ++it) {
+    entries.push_back({now, *it, _slots[FindSlot(*it)].event.entryPoint});
+  }
+  std::vector<LookaheadEntry> pending;
+  _immediateEventQueue.peek([&pending, now](::Smp::Services::EventId eventId,
+                                           const ::Smp::IEntryPoint *ep) {
+    pending.push_back({now, eventId, ep});
+  });
+  for (auto it = pending.rbegin();
+       it != pending.rend() && entries.size() < count; ++it) {
+    entries.push_back(*it);
+  }
+
+  // merge the first slots of both scheduling tables
+  std::vector<SlotIndex> heapSlots;
+  std::vector<SlotIndex> wheelSlots;
+  _events_table.first(count, heapSlots);
+  _timingWheel.first(count, wheelSlots);
+  const auto less = [this](SlotIndex lhs, SlotIndex rhs) {
+    const auto &left = _slots[lhs];
+    const auto &right = _slots[rhs];
+    if (left.event.nextScheduleSimulationTime !=
+        right.event.nextScheduleSimulationTime) {
+      return left.event.nextScheduleSimulationTime <
+             right.event.nextScheduleSimulationTime;
+    }
+    return EventList::key_compare{}(left.id, right.id);
+  };
+  std::vector<SlotIndex> slots;
+  slots.reserve(heapSlots.size() + wheelSlots.size());
+  std::merge(heapSlots.begin(), heapSlots.end(), wheelSlots.begin(),
+             wheelSlots.end(), std::back_inserter(slots), less);
+
+  for (auto it = slots.begin(); it != slots.end() && entries.size() < count;
+       ++it) {
+    const auto &entry = _slots[*it];
+    // the internal hold event is never reached
+    if (entry.event.nextScheduleSimulationTime == MaxDuration) {
+      break;
+    }
+    if (entry.rateGroup == RateGroup::npos) {
+      entries.push_back({entry.event.nextScheduleSimulationTime, entry.id,
+                         entry.event.entryPoint});
+      continue;
+    }
+    // the members of a rate group are executed with their leader
+    const auto &group = _rateGroups[entry.rateGroup];
+    for (auto position = group.next;
+         position < group.members.size() && entries.size() < count;
+         ++position) {
+      const auto &member = _slots[group.members[position]];
+      entries.push_back({member.event.nextScheduleSimulationTime, member.id,
+                         member.event.entryPoint});
+    }
+  }
+  return entries;
+}
+
+::Smp::Int32 XsmpScheduler::Lookahead(::Smp::Int32 count) {
+  const auto entries =
+      GetNextEvents(count > 0 ? static_cast<std::size_t>(count) : 0);
+  const std::scoped_lock lck{_lookaheadMutex};
+  _lookahead.clear();
+  for (const auto &entry : entries) {
+    _lookahead.push_back({entry.time, entry.eventId,
+                          ::Xsmp::Helper::GetPath(entry.entryPoint)});
+  }
+  return static_cast<::Smp::Int32>(_lookahead.size());
+}
+
+XsmpScheduler::LookaheadItem
+XsmpScheduler::GetLookaheadItem(::Smp::Int32 index) {
+  const std::scoped_lock lck{_lookaheadMutex};
+  if (index < 0 || static_cast<std::size_t>(index) >= _lookahead.size()) {
+    ::Xsmp::Exception::throwInvalidArrayIndex(
+        this, _lookahead.size(), static_cast<::Smp::UInt64>(index));
+  }
+  return _lookahead[static_cast<std::size_t>(index)];
+}
+
+::Smp::Duration XsmpScheduler::GetLookaheadTime(::Smp::Int32 index) {
+  return GetLookaheadItem(index).time;
+}
+
+::Smp::Int64 XsmpScheduler::GetLookaheadEventId(::Smp::Int32 index) {
+  return GetLookaheadItem(index).eventId;
+}
+
+::Smp::String8 XsmpScheduler::GetLookaheadEntryPoint(::Smp::Int32 index) {
+  // the snapshot may be replaced by another thread: the returned string is
+  // owned by the calling thread
+  thread_local std::string entryPoint;
+  entryPoint = GetLookaheadItem(index).entryPoint;
+  return entryPoint.c_str();
+}
+
+::Smp::Duration XsmpScheduler::RunSynchronously() {
+  // the stop requests are reset even if the run fails
+  struct StopRequestsReset {
+    XsmpScheduler &scheduler;
+    ~StopRequestsReset() {
+      scheduler._holdAtNextTime = false;
+      scheduler._stopTime = MaxDuration;
+    }
+  } reset{*this};
+
+  auto *simulator = GetSimulator();
+  const std::size_t runCount = _runCount;
+  // the simulator executes the scheduler on the calling thread
+  simulator->Run();
+  // the simulator refuses to run during a state transition
+  if (_runCount == runCount) {
+    ::Xsmp::Exception::throwInvalidSimulatorState(this, simulator->GetState());
+  }
+  return simulator->GetTimeKeeper()->GetSimulationTime();
+}
+
+::Smp::Duration XsmpScheduler::RunToNextEvent() {
+  if (auto state = GetSimulator()->GetState();
+      state != ::Smp::SimulatorStateKind::SSK_Standby) {
+    ::Xsmp::Exception::throwInvalidSimulatorState(this, state);
+  }
+  _holdAtNextTime = true;
+  return RunSynchronously();
+}
+
+::Smp::Duration XsmpScheduler::Step(::Smp::Duration duration) {
+  const auto currentTime =
+      GetSimulator()->GetTimeKeeper()->GetSimulationTime();
+  if (duration < 0) {
+    ::Xsmp::Exception::throwInvalidEventTime(this, currentTime + duration,
+                                             currentTime);
+  }
+  return RunUntil(duration > MaxDuration - currentTime
+                      ? MaxDuration
+                      : currentTime + duration);
+}
+
+::Smp::Duration XsmpScheduler::RunUntil(::Smp::Duration simulationTime) {
+  auto *simulator = GetSimulator();
+  if (auto state = simulator->GetState();
+      state != ::Smp::SimulatorStateKind::SSK_Standby) {
+    ::Xsmp::Exception::throwInvalidSimulatorState(this, state);
+  }
+  if (const auto currentTime =
+          simulator->GetTimeKeeper()->GetSimulationTime();
+      simulationTime < currentTime) {
+    ::Xsmp::Exception::throwInvalidEventTime(this, simulationTime,
+                                             currentTime);
+  }
+  _stopTime = simulationTime;
+  return RunSynchronously();
+}
+
+std::size_t XsmpScheduler::GetExecutionThreads() const noexcept {
+  return _executionThreads;
+}
+
+void XsmpScheduler::SetExecutionGroup(const ::Smp::IEntryPoint *entryPoint,
+                                      ::Smp::UInt32 group) {
+  const std::scoped_lock lck{_eventsMutex};
+  if (group) {
+    _executionGroups.insert_or_assign(entryPoint, group);
+  } else {
+    _executionGroups.erase(entryPoint);
+  }
+}
+
+::Smp::UInt32
+XsmpScheduler::GetExecutionGroup(const ::Smp::IEntryPoint *entryPoint) const {
+  const std::scoped_lock lck{_eventsMutex};
+  if (auto it = _executionGroups.find(entryPoint);
+      it != _executionGroups.end()) {
+    return it->second;
+  }
+  return 0;
+}
+
+XsmpScheduler::SlotIndex
+XsmpScheduler::AllocateSlot(::Smp::Services::EventId eventId,
+                            const Event &event) {
+  SlotIndex slot;
+  if (_freeSlots.empty()) {
+    slot = static_cast<SlotIndex>(_slots.size());
+    _slots.push_back(Slot{eventId, event, EventHeap::npos, TimingWheel::npos,
+                          InvalidSlot, InvalidSlot, RateGroup::npos});
+  } else {
+    slot = _freeSlots.back();
+    _freeSlots.pop_back();
+    _slots[slot] = Slot{eventId,           event,       EventHeap::npos,
+                        TimingWheel::npos, InvalidSlot, InvalidSlot,
+                        RateGroup::npos};
+  }
+  _events.try_emplace(eventId, slot);
+  return slot;
+}
+
+void XsmpScheduler::ReleaseSlot(SlotIndex slot) {
+  Unschedule(slot);
+  auto &entry = _slots[slot];
+  _events.erase(entry.id);
+  entry.event.entryPoint = nullptr;
+  _freeSlots.push_back(slot);
+}
+
+void XsmpScheduler::Schedule(SlotIndex slot) {
+  if (!_timingWheel.push(slot)) {
+    _events_table.push(slot);
+  }
+}
+
+void XsmpScheduler::Unschedule(SlotIndex slot) {
+  const auto &entry = _slots[slot];
+  if (entry.bucket != TimingWheel::npos) {
+    _timingWheel.erase(slot);
+  }
+  if (entry.heapIndex != EventHeap::npos) {
+    _events_table.erase(slot);
+  }
+}
+
+void XsmpScheduler::Reschedule(SlotIndex slot) {
+  const auto &entry = _slots[slot];
+  if (entry.bucket != TimingWheel::npos) {
+    _timingWheel.erase(slot);
+    Schedule(slot);
+  } else if (entry.heapIndex != EventHeap::npos) {
+    if (_timingWheel.push(slot)) {
+      _events_table.erase(slot);
+    } else {
+      _events_table.update(slot);
+    }
+  } else {
+    Schedule(slot);
+  }
+}
+
+void XsmpScheduler::SetRateGroupCoalescing(bool enabled) {
+  const std::scoped_lock lck{_eventsMutex};
+  if (enabled == _rateGroupCoalescing) {
+    return;
+  }
+  _rateGroupCoalescing = enabled;
+  if (!enabled) {
+    // dissolve all the groups
+    for (auto &group : _rateGroups) {
+      while (!group.members.empty()) {
+        LeaveRateGroup(group.members.back(), true);
+      }
+    }
+    _rateGroups.clear();
+    _freeRateGroups.clear();
+    return;
+  }
+  // merge the events already posted, in posting order
+  std::vector<std::pair<::Smp::Services::EventId, SlotIndex>> slots;
+  for (const auto &[eventId, slot] : _events) {
+    if (IsScheduled(_slots[slot])) {
+      slots.emplace_back(eventId, slot);
+    }
+  }
+  std::sort(slots.begin(), slots.end(), [](const auto &lhs, const auto &rhs) {
+    return EventList::key_compare{}(lhs.first, rhs.first);
+  });
+  for (const auto &[eventId, slot] : slots) {
+    Unschedule(slot);
+    if (!JoinRateGroup(slot)) {
+      Schedule(slot);
+    }
+  }
+}
+
+bool XsmpScheduler::IsRateGroupCoalescing() const {
+  const std::scoped_lock lck{_eventsMutex};
+  return _rateGroupCoalescing;
+}
+
+std::size_t XsmpScheduler::GetRateGroupCount() const {
+  const std::scoped_lock lck{_eventsMutex};
+  return _rateGroups.size() - _freeRateGroups.size();
+}
+
+bool XsmpScheduler::JoinRateGroup(SlotIndex slot) {
+  auto &entry = _slots[slot];
+  const auto &event = entry.event;
+  if (!_rateGroupCoalescing ||
+      event.kind != ::Smp::Services::TimeKind::TK_SimulationTime ||
+      event.repeat != -1 || event.cycleTime <= 0) {
+    return false;
+  }
+  // the number of distinct rates is small: a linear lookup is enough
+  for (std::uint32_t index = 0; index < _rateGroups.size(); ++index) {
+    auto &group = _rateGroups[index];
+    if (!group.members.empty() && group.cycleTime == event.cycleTime &&
+        _slots[group.members.front()].event.nextScheduleSimulationTime ==
+            event.nextScheduleSimulationTime) {
+      group.members.push_back(slot);
+      entry.rateGroup = index;
+      return true;
+    }
+  }
+  // create a new group led by this event
+  std::uint32_t index;
+  if (_freeRateGroups.empty()) {
+    index = static_cast<std::uint32_t>(_rateGroups.size());
+    _rateGroups.push_back(RateGroup{event.cycleTime, {slot}, 0});
+  } else {
+    index = _freeRateGroups.back();
+    _freeRateGroups.pop_back();
+    _rateGroups[index] = RateGroup{event.cycleTime, {slot}, 0};
+  }
+  entry.rateGroup = index;
+  Schedule(slot);
+  return true;
+}
+
+void XsmpScheduler::LeaveRateGroup(SlotIndex slot, bool schedule) {
+  auto &entry = _slots[slot];
+  const auto index = entry.rateGroup;
+  auto &group = _rateGroups[index];
+  const auto it = std::find(group.members.begin(), group.members.end(), slot);
+  const auto position = static_cast<std::size_t>(it - group.members.begin());
+  if (position == 0) {
+    Unschedule(slot);
+  }
+  group.members.erase(it);
+  entry.rateGroup = RateGroup::npos;
+  if (position < group.next) {
+    // the event is already executed in the current cycle
+    --group.next;
+    if (entry.id == _currentEventId) {
+      // the member being executed is re-armed after its execution
+      schedule = false;
+    } else {
+      entry.event.nextScheduleSimulationTime += entry.event.cycleTime;
+      entry.event.time += entry.event.cycleTime;
+    }
+  }
+  if (group.members.empty()) {
+    group.next = 0;
+    _freeRateGroups.push_back(index);
+  } else if (position == 0) {
+    // the next member leads the group
+    Schedule(group.members.front());
+  }
+  if (schedule) {
+    Schedule(slot);
+  }
+}
+
+bool XsmpScheduler::IsScheduled(const Slot &slot) noexcept {
+  return slot.heapIndex != EventHeap::npos ||
+         slot.bucket != TimingWheel::npos;
+}
+
+::Smp::Duration XsmpScheduler::GetNextEventTime() const {
+  auto time = _timingWheel.next();
+  if (!_events_table.empty()) {
+    time = std::min(
+        time, _slots[_events_table.top()].event.nextScheduleSimulationTime);
+  }
+  return time;
+}
+
+XsmpScheduler::SlotIndex
+XsmpScheduler::FindSlot(::Smp::Services::EventId eventId) const {
+  if (auto it = _events.find(eventId); it != _events.end()) {
+    return it->second;
+  }
+  return InvalidSlot;
+}
+
+XsmpScheduler::SlotIndex
+XsmpScheduler::FindEvent(::Smp::Services::EventId eventId) {
+  auto slot = FindSlot(eventId);
+  // the event may be an immediate event not yet collected
+  if (slot == InvalidSlot && !_immediateEventQueue.empty()) {
+    CollectImmediateEvents();
+    slot = FindSlot(eventId);
+  }
+  return slot;
+}
+
+void XsmpScheduler::CollectImmediateEvents() {
+  if (_immediateEventQueue.empty()) {
+    return;
+  }
   auto time = GetSimulator()->GetTimeKeeper()->GetSimulationTime();
-  _events.try_emplace(_lastEventId,
-                      Event{entryPoint, time, time, 0, 0,
-                            ::Smp::Services::TimeKind::TK_SimulationTime});
+  _immediateEventQueue.drain(
+      [this, time](::Smp::Services::EventId eventId,
+                   const ::Smp::IEntryPoint *entryPoint) {
+        AllocateSlot(eventId,
+                     Event{entryPoint, time, time, 0, 0,
+                           ::Smp::Services::TimeKind::TK_SimulationTime});
+        _immediate_events.emplace(eventId);
+      });
+}
 
-  _immediate_events.emplace(_lastEventId);
-  return _lastEventId;
+::Smp::Services::EventId
+XsmpScheduler::AddImmediateEvent(const ::Smp::IEntryPoint *entryPoint) {
+  // the event is queued without locking the scheduler tables, it is moved to
+  // the events pool by the scheduler thread before its execution
+  const auto eventId = ++_lastEventId;
+  _immediateEventQueue.push(eventId, entryPoint);
+  return eventId;
 }
 
 ::Smp::Services::EventId
@@ -154,10 +1683,12 @@ XsmpScheduler::AddEvent(const ::Smp::IEntryPoint *entryPoint,
   const std::scoped_lock lck{_eventsMutex};
 
   ++_lastEventId;
-  _events.try_emplace(_lastEventId, Event{entryPoint, simulationTime, time,
-                                          cycleTime, repeat, kind});
-
-  _events_table.try_emplace(simulationTime).first->second.emplace(_lastEventId);
+  if (const auto slot =
+          AllocateSlot(_lastEventId, Event{entryPoint, simulationTime, time,
+                                           cycleTime, repeat, kind});
+      !JoinRateGroup(slot)) {
+    Schedule(slot);
+  }
 
   GetSimulator()->GetLogger()->Log(entryPoint, "Event posted",
                                    ::Smp::Services::ILogger::LMK_Debug);
@@ -214,21 +1745,109 @@ XsmpScheduler::AddEvent(const ::Smp::IEntryPoint *entryPoint,
   }
   ::Smp::Services::EventId eventId = -1;
   {
-    // create the event
+    // create the event
+    const std::scoped_lock lck{_eventsMutex, _zuluEventsTableMutex};
+    eventId = ++_lastEventId;
+    AllocateSlot(eventId, Event{entryPoint, zuluTime, zuluTime, cycleTime,
+                                repeat,
+                                ::Smp::Services::TimeKind::TK_ZuluTime});
+
+    // insert the event in the zulu event table
+    _zulu_events_table.try_emplace(zuluTime).first->second.emplace(eventId);
+  }
+  NotifyZuluThread();
+
+  GetSimulator()->GetLogger()->Log(entryPoint, "Event posted",
+                                   ::Smp::Services::ILogger::LMK_Debug);
+  return eventId;
+}
+
+std::vector<::Smp::Services::EventId>
+XsmpScheduler::AddEvents(const EventSpec *events, std::size_t count) {
+
+  // query the time keeper once for the whole batch
+  auto *timeKeeper = GetSimulator()->GetTimeKeeper();
+  const auto currentSimulationTime = timeKeeper->GetSimulationTime();
+  bool hasMissionEvents = false;
+  bool hasEpochEvents = false;
+  bool hasZuluEvents = false;
+  for (std::size_t i = 0; i < count; ++i) {
+    hasMissionEvents |=
+        events[i].kind == ::Smp::Services::TimeKind::TK_MissionTime;
+    hasEpochEvents |= events[i].kind == ::Smp::Services::TimeKind::TK_EpochTime;
+    hasZuluEvents |= events[i].kind == ::Smp::Services::TimeKind::TK_ZuluTime;
+  }
+  const ::Smp::Duration missionTime =
+      hasMissionEvents ? timeKeeper->GetMissionTime() : 0;
+  const ::Smp::DateTime epochTime =
+      hasEpochEvents ? timeKeeper->GetEpochTime() : 0;
+  const ::Smp::DateTime zuluTime =
+      hasZuluEvents ? timeKeeper->GetZuluTime() : 0;
+
+  // check all the events before posting any of them
+  std::vector<Event> newEvents;
+  newEvents.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto &spec = events[i];
+    ::Smp::Duration simulationTime = spec.time;
+    switch (spec.kind) {
+    case ::Smp::Services::TimeKind::TK_SimulationTime:
+      simulationTime = currentSimulationTime + spec.time;
+      break;
+    case ::Smp::Services::TimeKind::TK_MissionTime:
+      simulationTime = currentSimulationTime + spec.time - missionTime;
+      break;
+    case ::Smp::Services::TimeKind::TK_EpochTime:
+      simulationTime = currentSimulationTime + spec.time - epochTime;
+      break;
+    case ::Smp::Services::TimeKind::TK_ZuluTime:
+      // check zulu time not in the past
+      if (spec.time < zuluTime) {
+        ::Xsmp::Exception::throwInvalidEventTime(this, spec.time, zuluTime);
+      }
+      break;
+    }
+    if (spec.kind != ::Smp::Services::TimeKind::TK_ZuluTime &&
+        simulationTime < currentSimulationTime) {
+      ::Xsmp::Exception::throwInvalidEventTime(this, simulationTime,
+                                               currentSimulationTime);
+    }
+    if (spec.repeat != 0 && spec.cycleTime <= 0) {
+      ::Xsmp::Exception::throwInvalidCycleTime(this, spec.cycleTime);
+    }
+    newEvents.push_back(Event{spec.entryPoint, simulationTime, spec.time,
+                              spec.cycleTime, spec.repeat, spec.kind});
+  }
+
+  std::vector<::Smp::Services::EventId> eventIds;
+  eventIds.reserve(count);
+  {
     const std::scoped_lock lck{_eventsMutex, _zuluEventsTableMutex};
-    eventId = ++_lastEventId;
-    _events.try_emplace(eventId,
-                        Event{entryPoint, zuluTime, zuluTime, cycleTime, repeat,
-                              ::Smp::Services::TimeKind::TK_ZuluTime});
-
-    // insert the event in the zulu event table
-    _zulu_events_table.try_emplace(zuluTime).first->second.emplace(eventId);
+    _events.reserve(_events.size() + count);
+    for (const auto &event : newEvents) {
+      const auto eventId = ++_lastEventId;
+      const auto slot = AllocateSlot(eventId, event);
+      if (event.kind == ::Smp::Services::TimeKind::TK_ZuluTime) {
+        // insert the event in the zulu event table
+        _zulu_events_table.try_emplace(event.time).first->second.emplace(
+            eventId);
+      } else if (!JoinRateGroup(slot)) {
+        Schedule(slot);
+      }
+      eventIds.push_back(eventId);
+    }
+  }
+  if (hasZuluEvents) {
+    NotifyZuluThread();
   }
-  _zuluCv.notify_one();
 
-  GetSimulator()->GetLogger()->Log(entryPoint, "Event posted",
-                                   ::Smp::Services::ILogger::LMK_Debug);
-  return eventId;
+  if (auto *logger = GetSimulator()->GetLogger();
+      count && ::Xsmp::Helper::IsLogEnabled(
+                   logger, this, ::Smp::Services::ILogger::LMK_Debug)) {
+    logger->Log(this, (std::to_string(count) + " events posted").c_str(),
+                ::Smp::Services::ILogger::LMK_Debug);
+  }
+  return eventIds;
 }
 
 void XsmpScheduler::SetEventTime(::Smp::Services::EventId eventId,
@@ -237,27 +1856,23 @@ void XsmpScheduler::SetEventTime(::Smp::Services::EventId eventId,
                                  ::Smp::Services::TimeKind kind) {
 
   const std::scoped_lock lck{_eventsMutex};
-  auto it = _events.find(eventId);
+  auto slot = FindEvent(eventId);
 
-  if (it == _events.end() || it->second.kind != kind) {
+  if (slot == InvalidSlot || _slots[slot].event.kind != kind) {
     ::Xsmp::Exception::throwInvalidEventId(this, eventId);
   }
-  auto &events = _events_table[it->second.nextScheduleSimulationTime];
-
-  events.erase(eventId);
-
-  if (events.empty()) {
-    _events_table.erase(it->second.nextScheduleSimulationTime);
+  if (_slots[slot].rateGroup != RateGroup::npos) {
+    LeaveRateGroup(slot, false);
   }
+
   if (simulationTime < GetSimulator()->GetTimeKeeper()->GetSimulationTime()) {
-    _events.erase(it);
+    ReleaseSlot(slot);
     return;
   }
-
-  it->second.nextScheduleSimulationTime = simulationTime;
-  it->second.time = time;
-
-  _events_table.try_emplace(simulationTime).first->second.emplace(eventId);
+  auto &entry = _slots[slot];
+  entry.event.nextScheduleSimulationTime = simulationTime;
+  entry.event.time = time;
+  Reschedule(slot);
 }
 
 void XsmpScheduler::SetEventSimulationTime(::Smp::Services::EventId event,
@@ -291,110 +1906,126 @@ void XsmpScheduler::SetEventZuluTime(::Smp::Services::EventId event,
   {
     auto currentZulu = GetSimulator()->GetTimeKeeper()->GetZuluTime();
     const std::scoped_lock lck{_eventsMutex, _zuluEventsTableMutex};
-    auto it = _events.find(event);
+    auto slot = FindEvent(event);
 
-    if (it == _events.end() ||
-        it->second.kind != ::Smp::Services::TimeKind::TK_ZuluTime) {
+    if (slot == InvalidSlot || _slots[slot].event.kind !=
+                                   ::Smp::Services::TimeKind::TK_ZuluTime) {
       ::Xsmp::Exception::throwInvalidEventId(this, event);
     }
-    auto &events = _zulu_events_table[it->second.nextScheduleSimulationTime];
-
-    events.erase(event);
+    auto &entry = _slots[slot].event;
+    _zulu_events_table[entry.nextScheduleSimulationTime].erase(event);
 
     if (zuluTime < currentZulu) {
-      _events.erase(it);
+      ReleaseSlot(slot);
       // TODO log warning
       return;
     }
 
-    it->second.nextScheduleSimulationTime = zuluTime;
+    entry.nextScheduleSimulationTime = zuluTime;
     _zulu_events_table.try_emplace(zuluTime).first->second.emplace(event);
   }
-  _zuluCv.notify_one();
+  NotifyZuluThread();
 }
 
 void XsmpScheduler::SetEventCycleTime(::Smp::Services::EventId event,
                                       ::Smp::Duration cycleTime) {
 
   const std::scoped_lock lck{_eventsMutex};
-  auto it = _events.find(event);
-  if (it == _events.end()) {
+  auto slot = FindEvent(event);
+  if (slot == InvalidSlot) {
     ::Xsmp::Exception::throwInvalidEventId(this, event);
   }
-  if (it->second.repeat > 0 && cycleTime <= 0) {
+  auto &entry = _slots[slot].event;
+  if (entry.repeat > 0 && cycleTime <= 0) {
     ::Xsmp::Exception::throwInvalidCycleTime(this, cycleTime);
   }
-  it->second.cycleTime = cycleTime;
+  if (_slots[slot].rateGroup != RateGroup::npos &&
+      entry.cycleTime != cycleTime) {
+    // a member already executed in the current cycle of its group is re-armed
+    // with its previous period
+    LeaveRateGroup(slot, true);
+  }
+  entry.cycleTime = cycleTime;
 }
 
 void XsmpScheduler::SetEventRepeat(::Smp::Services::EventId event,
                                    ::Smp::Int64 repeat) {
 
   const std::scoped_lock lck{_eventsMutex};
-  auto it = _events.find(event);
+  auto slot = FindEvent(event);
 
-  if (it == _events.end()) {
+  if (slot == InvalidSlot) {
     ::Xsmp::Exception::throwInvalidEventId(this, event);
   }
-  if (repeat != 0 && it->second.cycleTime <= 0) {
-    ::Xsmp::Exception::throwInvalidCycleTime(this, it->second.cycleTime);
+  auto &entry = _slots[slot].event;
+  if (repeat != 0 && entry.cycleTime <= 0) {
+    ::Xsmp::Exception::throwInvalidCycleTime(this, entry.cycleTime);
   }
-  it->second.repeat = repeat;
+  if (_slots[slot].rateGroup != RateGroup::npos && entry.repeat != repeat) {
+    LeaveRateGroup(slot, true);
+  }
+  entry.repeat = repeat;
 }
 
 void XsmpScheduler::RemoveEvent(::Smp::Services::EventId event) {
 
   const std::scoped_lock lck{_eventsMutex};
-  auto it = _events.find(event);
-  if (it == _events.end()) {
+  auto slot = FindEvent(event);
+  if (slot == InvalidSlot) {
     ::Xsmp::Exception::throwInvalidEventId(this, event);
   }
-  if (_currentEventId == event) {
-    it->second.repeat = 0;
+  if (_slots[slot].rateGroup != RateGroup::npos) {
+    LeaveRateGroup(slot, false);
+  }
+  auto &entry = _slots[slot].event;
+  if (_currentEventId == event || parallelEventId == event) {
+    entry.repeat = 0;
     return;
   }
 
-  if (it->second.kind == ::Smp::Services::TimeKind::TK_ZuluTime) {
+  if (entry.kind == ::Smp::Services::TimeKind::TK_ZuluTime) {
     const std::scoped_lock lckZulu{_zuluEventsTableMutex};
-
-    auto &events = _zulu_events_table[it->second.nextScheduleSimulationTime];
-
-    events.erase(event);
-
-    if (events.empty()) {
-      _events_table.erase(it->second.nextScheduleSimulationTime);
-    }
+    _zulu_events_table[entry.nextScheduleSimulationTime].erase(event);
   } else {
-
-    auto &events = _events_table[it->second.nextScheduleSimulationTime];
-
-    events.erase(event);
-
-    if (events.empty()) {
-      _events_table.erase(it->second.nextScheduleSimulationTime);
-    }
+    _immediate_events.erase(event);
   }
-  _events.erase(it);
+  ReleaseSlot(slot);
 }
 
 ::Smp::Services::EventId XsmpScheduler::GetCurrentEventId() const {
+  if (parallelEventId != -1) {
+    return parallelEventId;
+  }
   const std::scoped_lock lck{_eventsMutex};
   return _currentEventId;
 }
 
 ::Smp::Duration XsmpScheduler::GetNextScheduledEventTime() const {
   const std::scoped_lock lck{_eventsMutex};
-  if (_events_table.begin() != _events_table.end()) {
-    return _events_table.begin()->first;
-  }
-  return std::numeric_limits<::Smp::Duration>::max();
+  return GetNextEventTime();
 }
 
-void XsmpScheduler::Execute(::Smp::Services::EventId eventId) {
+void XsmpScheduler::Execute(::Smp::Services::EventId eventId, bool parallel) {
 
-  std::unique_lock lck{_eventsMutex};
+  std::unique_lock lck{_eventsMutex, std::defer_lock};
+  std::unique_lock execLck{_execMutex, std::defer_lock};
+  if (parallel) {
+    // the execution mutex is held by the scheduler thread
+    lck.lock();
+  } else {
+    std::lock(lck, execLck);
+  }
 
-  auto &event = _events.at(eventId);
+  auto slot = FindSlot(eventId);
+  // the event has been removed by a previous event
+  if (slot == InvalidSlot) {
+    return;
+  }
+  if (_slots[slot].rateGroup != RateGroup::npos) {
+    ExecuteRateGroup(_slots[slot].rateGroup, lck);
+    return;
+  }
+  const auto &event = _slots[slot].event;
 
   // skip event if epoch/mission time has changed and event is in the past
   bool skip = false;
@@ -410,54 +2041,114 @@ void XsmpScheduler::Execute(::Smp::Services::EventId eventId) {
   }
 
   if (!skip) {
-    const std::scoped_lock lck2(_execMutex);
-    _currentEventId = eventId;
+    auto &currentEventId = parallel ? parallelEventId : _currentEventId;
+    currentEventId = eventId;
+    const auto *entryPoint = event.entryPoint;
     lck.unlock();
-    ::Xsmp::Helper::SafeExecute(GetSimulator(), event.entryPoint);
+    ExecuteEntryPoint(eventId, entryPoint);
     lck.lock();
-    _currentEventId = -1;
+    currentEventId = -1;
+    // the event may have been removed during its execution
+    slot = FindSlot(eventId);
+    if (slot == InvalidSlot) {
+      return;
+    }
   }
 
-  if (event.repeat == 0) {
+  Rearm(slot);
+}
+
+void XsmpScheduler::Rearm(SlotIndex slot) {
+  auto &entry = _slots[slot];
+  if (entry.event.repeat == 0) {
     // remove the event
-    _events.erase(_events.find(eventId));
+    ReleaseSlot(slot);
   } else {
     // decrement the repeat
-    if (event.repeat > 0) {
-      event.repeat--;
+    if (entry.event.repeat > 0) {
+      entry.event.repeat--;
     }
     // compute the next time the event will be executed
+    entry.event.nextScheduleSimulationTime += entry.event.cycleTime;
+    entry.event.time += entry.event.cycleTime;
+
+    // reschedule the event in place
+    Reschedule(slot);
+  }
+}
+
+void XsmpScheduler::ExecuteRateGroup(std::uint32_t index,
+                                     std::unique_lock<std::mutex> &lck) {
+  // the members are executed from the position reached in the current cycle:
+  // the cycle resumes there after a hold
+  while (_rateGroups[index].next < _rateGroups[index].members.size()) {
+    auto &group = _rateGroups[index];
+    const auto &entry = _slots[group.members[group.next++]];
+    const auto *entryPoint = entry.event.entryPoint;
+    const auto eventId = entry.id;
+    _currentEventId = eventId;
+    lck.unlock();
+    ExecuteEntryPoint(eventId, entryPoint);
+    lck.lock();
+    _currentEventId = -1;
+    // the member has left its group during its execution
+    if (const auto slot = FindSlot(eventId);
+        slot != InvalidSlot && _slots[slot].rateGroup == RateGroup::npos) {
+      Rearm(slot);
+    }
+    // all the members have been removed during the execution
+    if (index >= _rateGroups.size() || _rateGroups[index].next == 0) {
+      return;
+    }
+    if (_simulationStatus == Status::Hold) {
+      return; // the leader remains scheduled at the current time
+    }
+  }
+  // schedule the next cycle of all the members
+  auto &group = _rateGroups[index];
+  group.next = 0;
+  for (const auto member : group.members) {
+    auto &event = _slots[member].event;
     event.nextScheduleSimulationTime += event.cycleTime;
     event.time += event.cycleTime;
-
-    // post the event in the table
-    _events_table.try_emplace(event.nextScheduleSimulationTime)
-        .first->second.emplace(eventId);
   }
+  Reschedule(group.members.front());
 }
 
 void XsmpScheduler::ExecuteZulu(::Smp::Services::EventId eventId) {
 
-  std::unique_lock lck(_eventsMutex);
+  std::unique_lock lck{_eventsMutex, std::defer_lock};
+  std::unique_lock execLck{_execMutex, std::defer_lock};
+  std::lock(lck, execLck);
 
-  auto &event = _events.at(eventId);
+  auto slot = FindSlot(eventId);
+  // the event has been removed
+  if (slot == InvalidSlot) {
+    return;
+  }
 
   // execute the event only in executing and standby states
   if (auto state = GetSimulator()->GetState();
       state == ::Smp::SimulatorStateKind::SSK_Executing ||
       state == ::Smp::SimulatorStateKind::SSK_Standby) {
 
-    const std::scoped_lock lck2(_execMutex);
     _currentEventId = eventId;
+    const auto *entryPoint = _slots[slot].event.entryPoint;
     lck.unlock();
-    ::Xsmp::Helper::SafeExecute(GetSimulator(), event.entryPoint);
+    ExecuteEntryPoint(eventId, entryPoint);
     lck.lock();
     _currentEventId = -1;
+    // the event may have been removed during its execution
+    slot = FindSlot(eventId);
+    if (slot == InvalidSlot) {
+      return;
+    }
   }
 
+  auto &event = _slots[slot].event;
   if (event.repeat == 0) {
     // remove the event
-    _events.erase(_events.find(eventId));
+    ReleaseSlot(slot);
   } else {
     // decrement the repeat
     if (event.repeat > 0) {
@@ -472,43 +2163,155 @@ void XsmpScheduler::ExecuteZulu(::Smp::Services::EventId eventId) {
   }
 }
 
-bool XsmpScheduler::ExecuteEvents(EventList &events) {
+void XsmpScheduler::ExecuteEntryPoint(::Smp::Services::EventId eventId,
+                                      const ::Smp::IEntryPoint *entryPoint) {
+  const bool profiling = _profiling;
+  const bool tracing = _tracer->IsRecording();
+  if (!profiling && !tracing) {
+    ::Xsmp::Helper::SafeExecute(GetSimulator(), entryPoint);
+    return;
+  }
+  const auto simulationTime =
+      GetSimulator()->GetTimeKeeper()->GetSimulationTime();
+  const auto sequence = tracing ? _tracer->Dispatch() : 0;
+  const auto start = std::chrono::steady_clock::now();
+  ::Xsmp::Helper::SafeExecute(GetSimulator(), entryPoint);
+  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  if (profiling) {
+    _profiler->Record(entryPoint, duration);
+  }
+  if (tracing) {
+    _tracer->Record(sequence, eventId, entryPoint, simulationTime, start,
+                    duration);
+  }
+}
+
+bool XsmpScheduler::ExecuteEvents(::Smp::Duration time) {
 
   // execute all events
-  while (!events.empty()) {
-    // swap the current list of events
-    EventList current;
-    current.swap(events);
-    for (auto it = current.begin(); it != current.end(); ++it) {
-      Execute(*it);
-      // process immediate events posted by this event
+  while (true) {
+    {
+      // collect the events scheduled at this time
+      const std::scoped_lock lck{_eventsMutex};
+      _pendingEvents.clear();
+      if (GetNextEventTime() == time) {
+        if (!_events_table.empty() &&
+            _slots[_events_table.top()].event.nextScheduleSimulationTime ==
+                time) {
+          _events_table.collect(time, _pendingEvents);
+        }
+        _timingWheel.collect(time, _pendingEvents);
+        std::sort(_pendingEvents.begin(), _pendingEvents.end(),
+                  EventList::key_compare{});
+      }
+    }
+    if (_pendingEvents.empty()) {
+      return true;
+    }
+    UpdateExecutionPool();
+    for (std::size_t index = 0; index < _pendingEvents.size();) {
+      if (_executionThreads > 1) {
+        index = ExecuteParallelEvents(index);
+      } else {
+        Execute(_pendingEvents[index++]);
+      }
+      // process immediate events posted by the executed events
       if (_simulationStatus == Status::Hold || !ExecuteImmediateEvents()) {
-        // store un-executed events and exit
-        events.insert(++it, current.end());
+        // un-executed events remain in the scheduling table
         return false;
       }
     }
   }
-  return true;
+}
+
+std::size_t XsmpScheduler::ExecuteParallelEvents(std::size_t first) {
+  {
+    // collect the consecutive events having an execution group
+    const std::scoped_lock lck{_eventsMutex};
+    _parallelEvents.clear();
+    for (auto index = first; index < _pendingEvents.size(); ++index) {
+      const auto eventId = _pendingEvents[index];
+      ::Smp::UInt32 group = 0;
+      // a rate group is executed alone
+      if (auto slot = FindSlot(eventId);
+          slot != InvalidSlot && _slots[slot].rateGroup == RateGroup::npos) {
+        if (auto it = _executionGroups.find(_slots[slot].event.entryPoint);
+            it != _executionGroups.end()) {
+          group = it->second;
+        }
+      }
+      if (group == 0) {
+        break;
+      }
+      _parallelEvents.emplace_back(group, eventId);
+    }
+  }
+  // an event without group is executed alone
+  if (_parallelEvents.size() < 2) {
+    Execute(_pendingEvents[first]);
+    return first + 1;
+  }
+
+  // keep the posting order inside each group
+  std::stable_sort(
+      _parallelEvents.begin(), _parallelEvents.end(),
+      [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+  _parallelGroups.clear();
+  for (std::size_t index = 0; index < _parallelEvents.size(); ++index) {
+    if (index == 0 ||
+        _parallelEvents[index].first != _parallelEvents[index - 1].first) {
+      _parallelGroups.push_back(index);
+    }
+  }
+  _parallelGroups.push_back(_parallelEvents.size());
+
+  const std::scoped_lock lck{_execMutex};
+  const std::function<void(std::size_t)> task = [this](std::size_t group) {
+    for (auto index = _parallelGroups[group];
+         index < _parallelGroups[group + 1]; ++index) {
+      Execute(_parallelEvents[index].second, true);
+      // un-executed events of the group remain in the scheduling table
+      if (_simulationStatus == Status::Hold) {
+        break;
+      }
+    }
+  };
+  if (_executionPool) {
+    _executionPool->Run(_parallelGroups.size() - 1, task);
+  } else {
+    for (std::size_t group = 0; group + 1 < _parallelGroups.size(); ++group) {
+      task(group);
+    }
+  }
+  return first + _parallelEvents.size();
 }
 bool XsmpScheduler::ExecuteImmediateEvents() {
   // execute all events
-  while (!_immediate_events.empty()) {
+  while (true) {
     // swap  the current list of events
     EventList events;
-    events.swap(_immediate_events);
+    {
+      const std::scoped_lock lck{_eventsMutex};
+      CollectImmediateEvents();
+      events.swap(_immediate_events);
+    }
+    if (events.empty()) {
+      return true;
+    }
 
     for (auto it = events.begin(); it != events.end(); ++it) {
       Execute(*it);
       // process immediate events posted by this event
       if (_simulationStatus == Status::Hold) {
         // store un-executed events and exit
+        const std::scoped_lock lck{_eventsMutex};
         _immediate_events.insert(++it, events.end());
         return false;
       }
     }
   }
-  return true;
 }
 
 void XsmpScheduler::InternalZuluRun() {
@@ -522,6 +2325,11 @@ void XsmpScheduler::InternalZuluRun() {
          it != _zulu_events_table.end() &&
          it->first <= GetSimulator()->GetTimeKeeper()->GetZuluTime();) {
 
+      // record the dispatch latency
+      ++_zuluJitter[Log2Bucket(
+          GetSimulator()->GetTimeKeeper()->GetZuluTime() - it->first,
+          _zuluJitter.size())];
+
       // execute all events
       while (!it->second.empty()) {
         // swap the event list
@@ -553,32 +2361,115 @@ void XsmpScheduler::InternalZuluRun() {
       _zuluCv.wait(
           lck, [this]() { return _terminate || !_zulu_events_table.empty(); });
     } else {
-      _zuluCv.wait_for(
-          lck,
-          std::chrono::nanoseconds{
-              std::max(static_cast<::Smp::Duration>(0),
-                       _zulu_events_table.begin()->first -
-                           GetSimulator()->GetTimeKeeper()->GetZuluTime())},
-          [this] {
-            return _terminate ||
-                   (!_zulu_events_table.empty() &&
-                    _zulu_events_table.begin()->first <=
-                        GetSimulator()->GetTimeKeeper()->GetZuluTime());
-          });
+      WaitZuluTime(lck, _zulu_events_table.begin()->first);
     }
   }
 }
 
+void XsmpScheduler::WaitZuluTime(std::unique_lock<std::mutex> &lck,
+                                 ::Smp::DateTime zuluTime) {
+  auto *timeKeeper = GetSimulator()->GetTimeKeeper();
+  // wake up before the event to busy-wait the remaining time
+  const auto wakeUpTime = zuluTime - _zuluSettings.spinWindow;
+
+  if (_zuluSettings.highPrecision) {
+    lck.unlock();
+    _zuluTimer->Wait(wakeUpTime);
+    lck.lock();
+  } else {
+    _zuluCv.wait_for(
+        lck,
+        std::chrono::nanoseconds{std::max(
+            static_cast<::Smp::Duration>(0),
+            wakeUpTime - timeKeeper->GetZuluTime())},
+        [this, timeKeeper] {
+          return _terminate ||
+                 (!_zulu_events_table.empty() &&
+                  _zulu_events_table.begin()->first -
+                          _zuluSettings.spinWindow <=
+                      timeKeeper->GetZuluTime());
+        });
+  }
+
+  // busy-wait the remaining time of the next event
+  if (_terminate || _zulu_events_table.empty() ||
+      _zuluSettings.spinWindow == 0) {
+    return;
+  }
+  const auto next = _zulu_events_table.begin()->first;
+  if (next - _zuluSettings.spinWindow > timeKeeper->GetZuluTime()) {
+    return; // woken up by a new event or a notification
+  }
+  lck.unlock();
+  while (timeKeeper->GetZuluTime() < next) {
+    std::this_thread::yield();
+  }
+  lck.lock();
+}
+
 void XsmpScheduler::Restore(::Smp::IStorageReader *reader) {
   const std::scoped_lock lck{_eventsMutex};
-  ::Xsmp::Persist::Restore(GetSimulator(), this, reader, _events, _events_table,
-                           _immediate_events, _lastEventId);
+  std::map<::Smp::Services::EventId, Event> events;
+  std::map<::Smp::Duration, EventList> eventsTable;
+  ::Smp::Services::EventId lastEventId = -1;
+  ::Xsmp::Persist::Restore(GetSimulator(), this, reader, events, eventsTable,
+                           _immediate_events, lastEventId);
+  // discard the immediate events posted before the restore
+  _immediateEventQueue.drain(
+      [](::Smp::Services::EventId, const ::Smp::IEntryPoint *) {});
+  _lastEventId = lastEventId;
+
+  // rebuild the events pool and the scheduling tables
+  _events_table.clear();
+  _timingWheel.clear(_timingWheel.tick(),
+                     eventsTable.empty() ? 0 : eventsTable.begin()->first);
+  _events.clear();
+  _slots.clear();
+  _freeSlots.clear();
+  _rateGroups.clear();
+  _freeRateGroups.clear();
+  for (const auto &[eventId, event] : events) {
+    AllocateSlot(eventId, event);
+  }
+  for (const auto &[time, eventIds] : eventsTable) {
+    for (const auto eventId : eventIds) {
+      if (auto slot = FindSlot(eventId);
+          slot != InvalidSlot && !JoinRateGroup(slot)) {
+        Schedule(slot);
+      }
+    }
+  }
 }
 
 void XsmpScheduler::Store(::Smp::IStorageWriter *writer) {
   const std::scoped_lock lck{_eventsMutex};
-  ::Xsmp::Persist::Store(GetSimulator(), this, writer, _events, _events_table,
-                         _immediate_events, _lastEventId);
+  CollectImmediateEvents();
+  // store the events with the same layout as the ordered tables
+  std::map<::Smp::Services::EventId, Event> events;
+  std::map<::Smp::Duration, EventList> eventsTable;
+  for (const auto &[eventId, slot] : _events) {
+    const auto &entry = _slots[slot];
+    events.try_emplace(eventId, entry.event);
+    if (IsScheduled(entry) && entry.rateGroup == RateGroup::npos) {
+      eventsTable[entry.event.nextScheduleSimulationTime].emplace(eventId);
+    }
+  }
+  // the members of the rate groups are stored as standalone events
+  for (const auto &group : _rateGroups) {
+    for (std::size_t position = 0; position < group.members.size();
+         ++position) {
+      const auto eventId = _slots[group.members[position]].id;
+      auto &event = events.at(eventId);
+      if (position < group.next) {
+        // already executed in the current cycle
+        event.nextScheduleSimulationTime += event.cycleTime;
+        event.time += event.cycleTime;
+      }
+      eventsTable[event.nextScheduleSimulationTime].emplace(eventId);
+    }
+  }
+  ::Xsmp::Persist::Store(GetSimulator(), this, writer, events, eventsTable,
+                         _immediate_events, _lastEventId.load());
 }
 
 void XsmpScheduler::_LeaveExecuting() {
@@ -592,14 +2483,23 @@ void XsmpScheduler::_LeaveExecuting() {
 void XsmpScheduler::_EnterExecuting() {
 
   auto *timeKeeper = GetSimulator()->GetTimeKeeper();
-  auto startZuluTime = timeKeeper->GetZuluTime();
+  // in free running mode, the zulu time is never queried
+  bool synchronized = !_freeRunning;
+  ::Smp::Duration startZuluTime =
+      synchronized ? timeKeeper->GetZuluTime() : 0;
 
   _simulationStatus = Status::Running;
+  ++_runCount;
 
   _load.clear();
   _speed.clear();
 
   ::Smp::Duration delay = 0;
+  // lateness of the previous step on the Zulu schedule
+  ::Smp::Duration lateness = 0;
+  // real time budget of the previous step and zulu time at which it started
+  ::Smp::Duration budget = 0;
+  ::Smp::Duration wakeZuluTime = 0;
 
   // process all immediate events
   if (!ExecuteImmediateEvents()) {
@@ -609,59 +2509,105 @@ void XsmpScheduler::_EnterExecuting() {
 
   std::unique_lock lck(_eventsMutex);
   // execute all events
-  for (auto it = _events_table.begin(); it != _events_table.end();
-       it = _events_table.erase(it)) {
+  while (!_events_table.empty() || !_timingWheel.empty()) {
+    const auto stopTime = _stopTime.load();
+    const auto time = std::min(GetNextEventTime(), stopTime);
     lck.unlock();
 
+    // nothing to step to: only the internal hold event is left
+    if (time == MaxDuration && _holdAtNextTime.exchange(false)) {
+      GetSimulator()->Hold(true);
+      return;
+    }
+
+    // the asynchronous emissions of the previous step are completed before
+    // the simulation time changes
+    ::Xsmp::Helper::FlushEvents(eventManager);
+
     // notify that simulation time will be changed
-    eventManager->Emit(::Smp::Services::IEventManager::SMP_PreSimTimeChangeId,
-                       false);
+    eventManager->Emit(::Smp::Services::IEventManager::SMP_PreSimTimeChangeId);
 
     if (_simulationStatus == Status::Hold) {
       return; // exit immediately if hold is requested
     }
-    auto duration = it->first - timeKeeper->GetSimulationTime();
-    delay += static_cast<::Smp::Duration>(static_cast<double>(duration) /
-                                          _targetSpeed) -
-             (timeKeeper->GetZuluTime() - startZuluTime);
-
-    auto endZuluTime = timeKeeper->GetZuluTime();
-    // update speed
-    if (duration) {
-      _speed.AddSample(static_cast<double>(endZuluTime - startZuluTime) /
-                       static_cast<double>(duration));
-    }
-    startZuluTime = endZuluTime;
+    if (_freeRunning) {
+      // execute as fast as possible
+      synchronized = false;
+    } else {
+      if (!synchronized) {
+        // (re)start the synchronization with zulu time
+        startZuluTime = timeKeeper->GetZuluTime();
+        delay = 0;
+        lateness = 0;
+        budget = 0;
+        _speed.clear();
+        synchronized = true;
+      }
+      auto duration = time - timeKeeper->GetSimulationTime();
+      delay += static_cast<::Smp::Duration>(static_cast<double>(duration) /
+                                            _targetSpeed) -
+               (timeKeeper->GetZuluTime() - startZuluTime);
+
+      auto endZuluTime = timeKeeper->GetZuluTime();
+      // update speed
+      if (duration) {
+        _speed.AddSample(static_cast<double>(endZuluTime - startZuluTime) /
+                         static_cast<double>(duration));
+      }
+      startZuluTime = endZuluTime;
+      // update load: part of the previous budget spent to execute the events
+      if (budget > 0) {
+        _load.AddSample(static_cast<double>(endZuluTime - wakeZuluTime) /
+                        static_cast<double>(budget));
+      }
+      budget = static_cast<::Smp::Duration>(static_cast<double>(duration) /
+                                            _targetSpeed);
+
+      // a negative delay is the lateness of this step on the Zulu schedule,
+      // only its growth is the lateness of this step on its own deadline: a
+      // step catching up the time lost by the previous ones is not an overrun
+      if (const auto stepLateness =
+              -delay - std::max<::Smp::Duration>(lateness, 0);
+          stepLateness > _overrunTolerance &&
+          !HandleOverrun(stepLateness, delay)) {
+        return; // exit immediately in case of hold
+      }
+      lateness = -delay;
 
-    // TODO handle free running
-    //  keep synchronized with zulu time
-    if (delay > 0) {
+      //  keep synchronized with zulu time
+      if (delay > 0) {
 
-      if (std::unique_lock lck2{_holdMutex};
-          _holdCv.wait_for(lck2, std::chrono::nanoseconds{delay}, [this] {
-            // continue to wait while Hold is not requested
-            return _simulationStatus == Status::Hold;
-          })) {
-        return; // exit immediately in case of hold
+        if (std::unique_lock lck2{_holdMutex};
+            _holdCv.wait_for(lck2, std::chrono::nanoseconds{delay}, [this] {
+              // continue to wait while Hold is not requested
+              return _simulationStatus == Status::Hold;
+            })) {
+          return; // exit immediately in case of hold
+        }
       }
+      wakeZuluTime = timeKeeper->GetZuluTime();
     }
 
     // change the simulation time
-    timeKeeper->SetSimulationTime(it->first);
+    timeKeeper->SetSimulationTime(time);
 
     // notify that simulation time has changed
     eventManager->Emit(::Smp::Services::IEventManager::SMP_PostSimTimeChangeId);
 
     // process all events (check for eventually events added by
     // SMP_PostSimTimeChangeId )
-    if (!ExecuteImmediateEvents() || !ExecuteEvents(it->second)) {
+    if (!ExecuteImmediateEvents() || !ExecuteEvents(time)) {
       return; // exit immediately in case of hold
     }
+    // stop at the event boundary requested by RunToNextEvent() or RunUntil()
+    if (_holdAtNextTime.exchange(false) ||
+        (time == stopTime && stopTime != MaxDuration)) {
+      _stopTime = MaxDuration;
+      GetSimulator()->Hold(true);
+      return;
+    }
     lck.lock();
   }
-
-  _load.clear();
-  _speed.clear();
 }
 
 void XsmpScheduler::_HoldEvent() {
@@ -669,6 +2615,355 @@ void XsmpScheduler::_HoldEvent() {
   GetSimulator()->Hold(true);
 }
 
+XsmpScheduler::ImmediateEventQueue::~ImmediateEventQueue() {
+  drain([](::Smp::Services::EventId, const ::Smp::IEntryPoint *) {});
+}
+
+void XsmpScheduler::ImmediateEventQueue::push(
+    ::Smp::Services::EventId eventId, const ::Smp::IEntryPoint *entryPoint) {
+  auto *node =
+      new Node{eventId, entryPoint, _head.load(std::memory_order_relaxed)};
+  while (!_head.compare_exchange_weak(node->next, node,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+XsmpScheduler::ImmediateEventQueue::Node *
+XsmpScheduler::ImmediateEventQueue::reverse(Node *node) noexcept {
+  Node *previous = nullptr;
+  while (node) {
+    auto *next = node->next;
+    node->next = previous;
+    previous = node;
+    node = next;
+  }
+  return previous;
+}
+
+bool XsmpScheduler::EventHeap::less(SlotIndex lhs,
+                                    SlotIndex rhs) const noexcept {
+  const auto &left = _slots[lhs];
+  const auto &right = _slots[rhs];
+  if (left.event.nextScheduleSimulationTime !=
+      right.event.nextScheduleSimulationTime) {
+    return left.event.nextScheduleSimulationTime <
+           right.event.nextScheduleSimulationTime;
+  }
+  // same time: first scheduled, first executed
+  return EventList::key_compare{}(left.id, right.id);
+}
+
+void XsmpScheduler::EventHeap::place(std::size_t pos, SlotIndex slot) noexcept {
+  _heap[pos] = slot;
+  _slots[slot].heapIndex = pos;
+}
+
+void XsmpScheduler::EventHeap::siftUp(std::size_t pos) {
+  const auto slot = _heap[pos];
+  while (pos > 0) {
+    const auto parent = (pos - 1) / arity;
+    if (!less(slot, _heap[parent])) {
+      break;
+    }
+    place(pos, _heap[parent]);
+    pos = parent;
+  }
+  place(pos, slot);
+}
+
+void XsmpScheduler::EventHeap::siftDown(std::size_t pos) {
+  const auto slot = _heap[pos];
+  const auto size = _heap.size();
+  while (true) {
+    const auto first = pos * arity + 1;
+    if (first >= size) {
+      break;
+    }
+    const auto last = std::min(first + arity, size);
+    auto best = first;
+    for (auto child = first + 1; child < last; ++child) {
+      if (less(_heap[child], _heap[best])) {
+        best = child;
+      }
+    }
+    if (!less(_heap[best], slot)) {
+      break;
+    }
+    place(pos, _heap[best]);
+    pos = best;
+  }
+  place(pos, slot);
+}
+
+void XsmpScheduler::EventHeap::push(SlotIndex slot) {
+  _heap.push_back(slot);
+  siftUp(_heap.size() - 1);
+}
+
+void XsmpScheduler::EventHeap::update(SlotIndex slot) {
+  const auto pos = _slots[slot].heapIndex;
+  if (pos > 0 && less(slot, _heap[(pos - 1) / arity])) {
+    siftUp(pos);
+  } else {
+    siftDown(pos);
+  }
+}
+
+void XsmpScheduler::EventHeap::erase(SlotIndex slot) {
+  const auto pos = _slots[slot].heapIndex;
+  const auto last = _heap.back();
+  _heap.pop_back();
+  _slots[slot].heapIndex = npos;
+  if (pos < _heap.size()) {
+    place(pos, last);
+    update(last);
+  }
+}
+
+void XsmpScheduler::EventHeap::clear() noexcept {
+  for (const auto slot : _heap) {
+    _slots[slot].heapIndex = npos;
+  }
+  _heap.clear();
+}
+
+void XsmpScheduler::EventHeap::first(std::size_t count,
+                                     std::vector<SlotIndex> &slots) const {
+  // best-first traversal: the next slot in scheduling order is always a child
+  // of an already collected slot
+  const auto greater = [this](std::size_t lhs, std::size_t rhs) {
+    return less(_heap[rhs], _heap[lhs]);
+  };
+  std::vector<std::size_t> candidates;
+  if (!_heap.empty()) {
+    candidates.push_back(0);
+  }
+  while (!candidates.empty() && slots.size() < count) {
+    std::pop_heap(candidates.begin(), candidates.end(), greater);
+    const auto pos = candidates.back();
+    candidates.pop_back();
+    slots.push_back(_heap[pos]);
+    const auto end = std::min(pos * arity + arity + 1, _heap.size());
+    for (auto child = pos * arity + 1; child < end; ++child) {
+      candidates.push_back(child);
+      std::push_heap(candidates.begin(), candidates.end(), greater);
+    }
+  }
+}
+
+void XsmpScheduler::EventHeap::collect(
+    ::Smp::Duration time, std::vector<::Smp::Services::EventId> &ids) const {
+  if (!_heap.empty()) {
+    collect(0, time, ids);
+  }
+}
+
+void XsmpScheduler::EventHeap::collect(
+    std::size_t pos, ::Smp::Duration time,
+    std::vector<::Smp::Services::EventId> &ids) const {
+  // events at the given time form a sub-tree rooted at the top of the heap
+  const auto &entry = _slots[_heap[pos]];
+  if (entry.event.nextScheduleSimulationTime != time) {
+    return;
+  }
+  ids.push_back(entry.id);
+  const auto first = pos * arity + 1;
+  const auto last = std::min(first + arity, _heap.size());
+  for (auto child = first; child < last; ++child) {
+    collect(child, time, ids);
+  }
+}
+
+XsmpScheduler::TimingWheel::TimingWheel(std::deque<Slot> &slots)
+    : _slots{slots} {
+  _buckets.fill(InvalidSlot);
+}
+
+void XsmpScheduler::TimingWheel::link(SlotIndex slot,
+                                      std::uint32_t bucket) noexcept {
+  auto &entry = _slots[slot];
+  entry.bucket = bucket;
+  entry.previous = InvalidSlot;
+  entry.next = _buckets[bucket];
+  if (entry.next != InvalidSlot) {
+    _slots[entry.next].previous = slot;
+  }
+  _buckets[bucket] = slot;
+  _occupied[bucket / 64] |= std::uint64_t{1} << (bucket % 64);
+}
+
+bool XsmpScheduler::TimingWheel::push(SlotIndex slot) {
+  const auto &event = _slots[slot].event;
+  // only cyclic events aligned on the tick are handled by the wheel
+  if (_tick <= 0 || event.repeat == 0 || event.cycleTime % _tick != 0 ||
+      event.nextScheduleSimulationTime < 0 ||
+      event.nextScheduleSimulationTime % _tick != 0) {
+    return false;
+  }
+  const auto tick =
+      static_cast<std::uint64_t>(event.nextScheduleSimulationTime / _tick);
+  // an empty wheel can be moved backward
+  if (_size == 0 && tick < _now) {
+    _now = tick;
+  }
+  return insert(slot, tick);
+}
+
+bool XsmpScheduler::TimingWheel::insert(SlotIndex slot, std::uint64_t tick) {
+  if (tick < _now) {
+    return false;
+  }
+  // the level is given by the highest bit that differs from the current tick
+  std::size_t level = 0;
+  for (auto diff = (tick ^ _now) >> levelBits; diff != 0; diff >>= levelBits) {
+    ++level;
+  }
+  if (level >= levels) {
+    return false;
+  }
+  const auto index = (tick >> (level * levelBits)) & levelMask;
+  link(slot, static_cast<std::uint32_t>(level * levelSize + index));
+  ++_size;
+  return true;
+}
+
+void XsmpScheduler::TimingWheel::erase(SlotIndex slot) {
+  auto &entry = _slots[slot];
+  if (entry.previous != InvalidSlot) {
+    _slots[entry.previous].next = entry.next;
+  } else {
+    _buckets[entry.bucket] = entry.next;
+    if (entry.next == InvalidSlot) {
+      _occupied[entry.bucket / 64] &=
+          ~(std::uint64_t{1} << (entry.bucket % 64));
+    }
+  }
+  if (entry.next != InvalidSlot) {
+    _slots[entry.next].previous = entry.previous;
+  }
+  entry.bucket = npos;
+  --_size;
+}
+
+void XsmpScheduler::TimingWheel::clear(::Smp::Duration tick,
+                                       ::Smp::Duration time) noexcept {
+  for (auto &head : _buckets) {
+    for (auto slot = head; slot != InvalidSlot; slot = _slots[slot].next) {
+      _slots[slot].bucket = npos;
+    }
+    head = InvalidSlot;
+  }
+  _occupied.fill(0);
+  _size = 0;
+  _tick = tick;
+  _now = _tick > 0 && time > 0 ? static_cast<std::uint64_t>(time / _tick) : 0;
+}
+
+std::size_t
+XsmpScheduler::TimingWheel::findBucket(std::size_t level,
+                                       std::size_t from) const noexcept {
+  for (auto index = from; index < levelSize;) {
+    const auto bucket = level * levelSize + index;
+    if (const auto bits = _occupied[bucket / 64] >> (bucket % 64); bits != 0) {
+      // count the trailing zeros of the remaining bits of the word
+      auto offset = std::size_t{0};
+      for (auto value = bits; (value & 1) == 0; value >>= 1) {
+        ++offset;
+      }
+      return index + offset;
+    }
+    index += 64 - bucket % 64;
+  }
+  return levelSize;
+}
+
+::Smp::Duration XsmpScheduler::TimingWheel::next() {
+  while (_size != 0) {
+    // events of the first level are exactly at the tick of their bucket
+    if (auto index = findBucket(0, _now & levelMask); index < levelSize) {
+      return static_cast<::Smp::Duration>(((_now & ~levelMask) | index) *
+                                          static_cast<std::uint64_t>(_tick));
+    }
+    // cascade the first non empty bucket of the upper levels
+    bool cascaded = false;
+    for (std::size_t level = 1; level < levels; ++level) {
+      const auto shift = level * levelBits;
+      const auto index = findBucket(level, ((_now >> shift) & levelMask) + 1);
+      if (index == levelSize) {
+        continue;
+      }
+      // move to the beginning of the bucket
+      _now = ((_now >> (shift + levelBits)) << (shift + levelBits)) |
+             (static_cast<std::uint64_t>(index) << shift);
+      const auto bucket = level * levelSize + index;
+      auto slot = _buckets[bucket];
+      _buckets[bucket] = InvalidSlot;
+      _occupied[bucket / 64] &= ~(std::uint64_t{1} << (bucket % 64));
+      while (slot != InvalidSlot) {
+        const auto next = _slots[slot].next;
+        --_size;
+        const auto time = _slots[slot].event.nextScheduleSimulationTime;
+        insert(slot, static_cast<std::uint64_t>(time / _tick));
+        slot = next;
+      }
+      cascaded = true;
+      break;
+    }
+    if (!cascaded) {
+      break;
+    }
+  }
+  return std::numeric_limits<::Smp::Duration>::max();
+}
+
+void XsmpScheduler::TimingWheel::collect(
+    ::Smp::Duration time, std::vector<::Smp::Services::EventId> &ids) const {
+  if (_tick <= 0 || time % _tick != 0) {
+    return;
+  }
+  const auto tick = static_cast<std::uint64_t>(time / _tick);
+  if ((tick >> levelBits) != (_now >> levelBits)) {
+    return;
+  }
+  for (auto slot = _buckets[tick & levelMask]; slot != InvalidSlot;
+       slot = _slots[slot].next) {
+    ids.push_back(_slots[slot].id);
+  }
+}
+
+void XsmpScheduler::TimingWheel::first(std::size_t count,
+                                       std::vector<SlotIndex> &slots) const {
+  // the buckets of a level are after the buckets of the lower levels, the
+  // buckets of the upper levels are not sorted
+  const auto less = [this](SlotIndex lhs, SlotIndex rhs) {
+    const auto &left = _slots[lhs];
+    const auto &right = _slots[rhs];
+    if (left.event.nextScheduleSimulationTime !=
+        right.event.nextScheduleSimulationTime) {
+      return left.event.nextScheduleSimulationTime <
+             right.event.nextScheduleSimulationTime;
+    }
+    return EventList::key_compare{}(left.id, right.id);
+  };
+  for (std::size_t level = 0; level < levels && slots.size() < count;
+       ++level) {
+    const auto shift = level * levelBits;
+    auto index = findBucket(level, ((_now >> shift) & levelMask) +
+                                       (level == 0 ? 0 : 1));
+    while (index < levelSize && slots.size() < count) {
+      const auto begin = slots.size();
+      for (auto slot = _buckets[level * levelSize + index];
+           slot != InvalidSlot; slot = _slots[slot].next) {
+        slots.push_back(slot);
+      }
+      std::sort(slots.begin() + static_cast<std::ptrdiff_t>(begin),
+                slots.end(), less);
+      index = findBucket(level, index + 1);
+    }
+  }
+}
+
 void XsmpScheduler::MovingAverage::AddSample(double sample) {
   const std::scoped_lock lck{_mutex};
   sum = sum + sample - samples[index];
@@ -20,13 +20,23 @@
 #include <Smp/Services/TimeKind.h>
 #include <Xsmp/Persist.h>
 #include <Xsmp/Services/XsmpSchedulerGen.h>
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 #include <thread>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 // ----------------------------------------------------------------------------
 // ------------------------ Types and Interfaces ------------------------
@@ -34,6 +44,11 @@
 
 namespace Xsmp::Services {
 
+class EntryPointProfiler;
+class EventTraceRecorder;
+class ExecutionPool;
+class ZuluTimer;
+
 class XsmpScheduler final : public XsmpSchedulerGen {
 public:
   // ------------------------------------------------------------------------------------
@@ -371,6 +386,301 @@ public:
   void SetTargetSpeed(double speed);
   double GetTargetSpeed() const noexcept;
 
+  /// Enable or disable the free running mode.
+  /// In free running mode, the events are executed as fast as possible: the
+  /// target speed is ignored and the scheduler never waits for the Zulu time.
+  /// @param freeRunning true to execute the events as fast as possible.
+  void SetFreeRunning(bool freeRunning) noexcept;
+  bool IsFreeRunning() const noexcept;
+
+  /// Set the tick of the timing wheel.
+  /// Cyclic events whose simulation time and cycle time are multiples of the
+  /// tick are scheduled in a hierarchical timing wheel (O(1) insertion and
+  /// re-arming) instead of the ordered scheduling table.
+  /// @param tick the tick of the timing wheel, or 0 to disable it.
+  void SetTimingWheelTick(::Smp::Duration tick);
+  ::Smp::Duration GetTimingWheelTick() const;
+
+  /// Set the number of threads used to execute events in parallel.
+  /// Events scheduled at the same simulation time whose entry points belong
+  /// to different execution groups are executed concurrently, with a barrier
+  /// before the next simulation time change.
+  /// @param count the number of threads (including the scheduler thread), or
+  /// 0 or 1 to execute all events sequentially.
+  /// @remarks It can be called from an entry point: the threads are created
+  ///          or released before the execution of the next simulation time.
+  void SetExecutionThreads(std::size_t count);
+  std::size_t GetExecutionThreads() const noexcept;
+
+  /// Set the execution group of an entry point.
+  /// Events of the same group are executed sequentially in posting order.
+  /// Entry points without group (group 0) are never executed concurrently
+  /// with other events.
+  /// @param entryPoint the entry point.
+  /// @param group the execution group, or 0 to remove the entry point from
+  /// its group.
+  void SetExecutionGroup(const ::Smp::IEntryPoint *entryPoint,
+                         ::Smp::UInt32 group);
+  ::Smp::UInt32 GetExecutionGroup(const ::Smp::IEntryPoint *entryPoint) const;
+
+  /// Description of an event to post with AddEvents().
+  struct EventSpec {
+    /// the entry point to call
+    const ::Smp::IEntryPoint *entryPoint;
+    /// the event time: a duration from now for TK_SimulationTime, an absolute
+    /// mission time for TK_MissionTime and an absolute date for TK_EpochTime
+    /// and TK_ZuluTime (same semantic as the Add<Kind>Event() operations).
+    ::Smp::Duration time;
+    /// the cycle time
+    ::Smp::Duration cycleTime;
+    /// the repeat count
+    ::Smp::Int64 repeat;
+    /// the time kind
+    ::Smp::Services::TimeKind kind;
+  };
+
+  /// Post a batch of events.
+  /// All the events are checked before any of them is posted: if an event is
+  /// invalid, an exception is raised and no event is posted.
+  /// The scheduler tables are locked and the time keeper is queried only
+  /// once for the whole batch.
+  /// @param events the events to post.
+  /// @param count the number of events.
+  /// @return the identifiers of the posted events, in the same order.
+  /// @throws Smp::Services::InvalidEventTime
+  /// @throws Smp::Services::InvalidCycleTime
+  std::vector<::Smp::Services::EventId> AddEvents(const EventSpec *events,
+                                                  std::size_t count);
+  std::vector<::Smp::Services::EventId>
+  AddEvents(const std::vector<EventSpec> &events) {
+    return AddEvents(events.data(), events.size());
+  }
+
+  /// Enable or disable the coalescing of cyclic events in rate groups.
+  /// Simulation time events repeated forever that share the same cycle time
+  /// and the same next simulation time are merged in a rate group: a single
+  /// scheduled event that executes the entry points of all its members in a
+  /// tight loop.
+  /// Each member keeps its own event id: changing its time, cycle time or
+  /// repeat count moves it out of its group and removing it only removes it
+  /// from its group.
+  /// The members of a group are executed consecutively in posting order, at
+  /// the position of the first member. Immediate events posted by a member are
+  /// executed after the whole group.
+  /// Enabling the coalescing also merges the events already posted.
+  /// @param enabled true to coalesce the cyclic events.
+  void SetRateGroupCoalescing(bool enabled);
+  bool IsRateGroupCoalescing() const;
+  /// @return the number of rate groups
+  std::size_t GetRateGroupCount() const;
+
+  /// Settings of the thread dispatching the Zulu time events.
+  struct ZuluDispatcherSettings {
+    /// wait for the next event with a timerfd armed with an absolute
+    /// CLOCK_REALTIME deadline instead of a condition variable (Linux only)
+    bool highPrecision{false};
+    /// duration of the busy-wait before each Zulu event, 0 to disable it
+    ::Smp::Duration spinWindow{0};
+    /// CPU the thread is pinned on, or -1
+    int cpu{-1};
+    /// SCHED_FIFO priority of the thread, or 0 to keep the default policy
+    int priority{0};
+  };
+
+  /// Configure the thread dispatching the Zulu time events.
+  /// Settings that cannot be applied on the current platform (or without the
+  /// required privileges) are reported as warnings.
+  /// @param settings the new settings.
+  void SetZuluDispatcherSettings(const ZuluDispatcherSettings &settings);
+  ZuluDispatcherSettings GetZuluDispatcherSettings() const;
+
+  /// Histogram of the dispatch latency of the Zulu time events.
+  /// Bucket 0 counts the events dispatched less than 1us after their Zulu
+  /// time, bucket i (i > 0) the events dispatched between 2^(i-1)us and
+  /// 2^i us after it, the last bucket includes all later events.
+  using ZuluJitterHistogram = std::array<::Smp::UInt64, 24>;
+  ZuluJitterHistogram GetZuluJitterHistogram() const;
+  void ResetZuluJitterHistogram();
+
+  /// Execution statistics of an entry point.
+  struct ProfileEntry {
+    /// the entry point, it may have been deleted since its executions
+    const ::Smp::IEntryPoint *entryPoint;
+    /// the path of the entry point at its first execution
+    std::string path;
+    /// the number of executions
+    ::Smp::UInt64 count;
+    /// the total, minimal and maximal wall time of an execution
+    ::Smp::Duration total;
+    ::Smp::Duration min;
+    ::Smp::Duration max;
+    /// bucket 0 counts the executions shorter than 1us, bucket i (i > 0) the
+    /// executions between 2^(i-1)us and 2^i us, the last bucket includes all
+    /// longer executions.
+    std::array<::Smp::UInt64, 32> histogram;
+  };
+
+  /// Enable or disable the profiling of the entry points.
+  /// The wall time of each entry point executed by the scheduler is recorded
+  /// in a storage local to the executing thread, without lock.
+  /// @param profiling true to record the executions.
+  void SetProfiling(bool profiling) noexcept;
+  bool IsProfiling() const noexcept;
+
+  /// Get the execution profile of the entry points.
+  /// @return the statistics of each executed entry point, by decreasing total
+  /// wall time.
+  std::vector<ProfileEntry> GetProfile() const;
+
+  void ResetProfile() override;
+  void DumpProfile(::Smp::String8 fileName) override;
+
+  /// An event executed during a traced simulation.
+  struct TraceRecord {
+    /// the simulation time of the execution
+    ::Smp::Duration simulationTime;
+    /// the Zulu time at the start of the execution
+    ::Smp::Duration zuluTime;
+    /// the event identifier
+    ::Smp::Services::EventId eventId;
+    /// the path of the entry point
+    std::string entryPoint;
+    /// the wall time of the execution
+    ::Smp::Duration duration;
+  };
+
+  /// Start to record the executed events in a binary trace file.
+  /// Each thread appends its records to its own ring buffer without lock and
+  /// a background thread writes them to the file. Records are dropped if a
+  /// ring buffer is full.
+  /// A trace already in progress is stopped.
+  /// @param fileName the trace file.
+  void StartTrace(::Smp::String8 fileName) override;
+  /// Stop to record the executed events, write the pending records and close
+  /// the trace file.
+  void StopTrace() override;
+  bool IsTracing() const noexcept;
+  /// @return the number of records dropped by the current or last trace.
+  ::Smp::UInt64 GetTraceDropCount() const noexcept;
+
+  /// Read a trace file.
+  /// @param fileName the trace file.
+  /// @return the records, in dispatch order.
+  std::vector<TraceRecord> ReadTrace(::Smp::String8 fileName) const;
+
+  /// Compare a trace with a reference trace, ignoring the Zulu times and the
+  /// durations: re-run the reference scenario with a trace to check that it
+  /// is deterministic.
+  /// The events of the same simulation time are compared by event id.
+  /// @param referenceFileName the reference trace file.
+  /// @param fileName the trace file to check.
+  /// @return an empty string if both traces are identical, otherwise the
+  /// description of the first divergence.
+  ::Smp::String8 CompareTrace(::Smp::String8 referenceFileName,
+                              ::Smp::String8 fileName) override;
+
+  /// @return the average part of the real time budget used to execute the
+  /// events.
+  double GetLoad();
+  /// @return the average ratio between the elapsed simulation time and the
+  /// elapsed Zulu time.
+  double GetSpeed();
+
+  /// Name of the event emitted by the OverrunPolicy::Emit policy.
+  static constexpr ::Smp::Char8 SchedulerOverrunEvent[] =
+      "XSMP_SchedulerOverrun";
+
+  /// Policy applied when a time step misses its Zulu deadline.
+  enum class OverrunPolicy : ::Smp::Int32 {
+    /// keep the lost time: the next steps are executed without waiting until
+    /// the scheduler is back on time
+    CatchUp,
+    /// drop the lost time: the deadlines of the next steps are computed from
+    /// the current Zulu time
+    SkipToNow,
+    /// hold the simulation before the late step
+    Hold,
+    /// emit the SchedulerOverrunEvent and catch up the lost time
+    Emit
+  };
+
+  /// Set the policy applied when a time step misses its Zulu deadline.
+  /// @param policy the overrun policy.
+  void SetOverrunPolicy(OverrunPolicy policy) noexcept;
+  OverrunPolicy GetOverrunPolicy() const noexcept;
+
+  /// Set the lateness below which a time step is not an overrun.
+  /// @param tolerance the tolerated lateness.
+  void SetOverrunTolerance(::Smp::Duration tolerance) noexcept;
+  ::Smp::Duration GetOverrunTolerance() const noexcept;
+
+  /// A step is late on its own deadline when it starts after the end of the
+  /// budget of the previous step: the steps that catch up the time lost by the
+  /// previous ones are not overruns.
+  /// @return the number of time steps that missed their Zulu deadline.
+  ::Smp::Int64 GetOverrunCount() const noexcept;
+  /// @return the worst lateness of a time step on its own Zulu deadline.
+  ::Smp::Duration GetMaxLateness() const noexcept;
+  /// Reset the overrun count and the worst lateness.
+  void ResetOverruns() noexcept;
+
+  /// An event of a lookahead snapshot.
+  struct LookaheadEntry {
+    /// the simulation time of the event
+    ::Smp::Duration time;
+    /// the event identifier
+    ::Smp::Services::EventId eventId;
+    /// the entry point of the event
+    const ::Smp::IEntryPoint *entryPoint;
+  };
+
+  /// Get the next simulation time events, in execution order.
+  /// The events are copied from the scheduling tables in a single short
+  /// critical section, without modifying them: the result is a snapshot that
+  /// is outdated as soon as an event is posted, modified or removed.
+  /// The immediate events come first, the Zulu time events are not
+  /// considered.
+  /// @param count the maximal number of events.
+  /// @return the next events.
+  std::vector<LookaheadEntry> GetNextEvents(std::size_t count);
+
+  ::Smp::Int32 Lookahead(::Smp::Int32 count) override;
+  ::Smp::Duration GetLookaheadTime(::Smp::Int32 index) override;
+  ::Smp::Int64 GetLookaheadEventId(::Smp::Int32 index) override;
+  ::Smp::String8 GetLookaheadEntryPoint(::Smp::Int32 index) override;
+
+  /// Run the simulation until all the events of the next scheduled simulation
+  /// time (and the immediate events) are executed, then hold it.
+  /// The simulation is executed on the calling thread and the call returns
+  /// once the simulation is held: no hold event has to be posted.
+  /// @return the simulation time reached.
+  /// @throws Smp::InvalidSimulatorState if the simulator is not in Standby
+  /// state.
+  ::Smp::Duration RunToNextEvent() override;
+
+  /// Run the simulation for the given duration, then hold it.
+  /// @param duration the duration to run.
+  /// @return the simulation time reached.
+  /// @throws Smp::InvalidSimulatorState if the simulator is not in Standby
+  /// state.
+  /// @throws Smp::Services::InvalidEventTime if the duration is negative.
+  ::Smp::Duration Step(::Smp::Duration duration) override;
+
+  /// Run the simulation until the given simulation time, then hold it.
+  /// The event loop is driven on the calling thread: the call returns once
+  /// all the events scheduled up to (and at) the given time are executed and
+  /// the simulation time is set to it, without posting a hold event nor
+  /// waiting for another thread.
+  /// In free running mode the simulation is executed as fast as possible,
+  /// otherwise it is still paced on the Zulu time.
+  /// @param simulationTime the simulation time to reach.
+  /// @return the simulation time reached (earlier if the simulation is held
+  /// in the meantime).
+  /// @throws Smp::InvalidSimulatorState if the simulator is not in Standby
+  /// state.
+  /// @throws Smp::Services::InvalidEventTime if the time is in the past.
+  ::Smp::Duration RunUntil(::Smp::Duration simulationTime) override;
+
 private:
   friend class ::Xsmp::Component::Helper;
   // this structure represent an event in the scheduling table
@@ -390,20 +700,236 @@ private:
       std::set<::Smp::Services::EventId,
                std::less<std::make_unsigned_t<::Smp::Services::EventId>>>;
 
+  using SlotIndex = std::uint32_t;
+  static constexpr SlotIndex InvalidSlot =
+      std::numeric_limits<SlotIndex>::max();
+
+  // an entry of the events pool.
+  // The index of a slot remains stable during the whole life of its event,
+  // released slots are recycled by the next posted events.
+  struct Slot {
+    ::Smp::Services::EventId id;
+    Event event;
+    std::size_t heapIndex;   // position in the scheduling heap (or npos)
+    std::uint32_t bucket;    // bucket in the timing wheel (or npos)
+    SlotIndex previous;      // previous slot in the same bucket
+    SlotIndex next;          // next slot in the same bucket
+    std::uint32_t rateGroup; // rate group of the event (or npos)
+  };
+
+  // a group of cyclic events sharing the same cycle time and the same next
+  // simulation time. Only the first member (the leader) is scheduled, the
+  // other members follow it.
+  struct RateGroup {
+    static constexpr std::uint32_t npos =
+        std::numeric_limits<std::uint32_t>::max();
+    ::Smp::Duration cycleTime;
+    std::vector<SlotIndex> members; // in posting order
+    // position of the next member to execute in the current cycle, the
+    // members before it are already executed
+    std::size_t next;
+  };
+
+  // Indexed 4-ary min heap of slots ordered by scheduled simulation time and
+  // then by posting order.
+  // Each slot stores its position in the heap so that an event can be
+  // rescheduled or removed in place without any allocation.
+  class EventHeap {
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    explicit EventHeap(std::deque<Slot> &slots) : _slots{slots} {}
+
+    bool empty() const noexcept { return _heap.empty(); }
+    std::size_t size() const noexcept { return _heap.size(); }
+    SlotIndex top() const { return _heap.front(); }
+
+    /// Insert a slot in the heap
+    void push(SlotIndex slot);
+    /// Restore the heap order after the scheduled time of a slot has changed
+    void update(SlotIndex slot);
+    /// Remove a slot from the heap
+    void erase(SlotIndex slot);
+    /// Remove all slots
+    void clear() noexcept;
+
+    /// Collect the ids of the events scheduled at the given time.
+    /// The time must be the time of the top slot.
+    void collect(::Smp::Duration time,
+                 std::vector<::Smp::Services::EventId> &ids) const;
+
+    /// Collect the first slots in scheduling order
+    /// @param count the maximal number of slots
+    /// @param slots the collected slots
+    void first(std::size_t count, std::vector<SlotIndex> &slots) const;
+
+  private:
+    static constexpr std::size_t arity = 4;
+    bool less(SlotIndex lhs, SlotIndex rhs) const noexcept;
+    void place(std::size_t pos, SlotIndex slot) noexcept;
+    void siftUp(std::size_t pos);
+    void siftDown(std::size_t pos);
+    void collect(std::size_t pos, ::Smp::Duration time,
+                 std::vector<::Smp::Services::EventId> &ids) const;
+
+    std::deque<Slot> &_slots;
+    std::vector<SlotIndex> _heap;
+  };
+
+  // Hierarchical timing wheel of cyclic events.
+  // Each level has 256 buckets, an event is stored in the level of the
+  // highest bit that differs between its tick and the current tick of the
+  // wheel, so that the buckets of the first level hold exactly one tick.
+  // Buckets are intrusive lists of slots.
+  class TimingWheel {
+  public:
+    static constexpr std::uint32_t npos =
+        std::numeric_limits<std::uint32_t>::max();
+
+    explicit TimingWheel(std::deque<Slot> &slots);
+
+    ::Smp::Duration tick() const noexcept { return _tick; }
+    bool empty() const noexcept { return _size == 0; }
+
+    /// Insert a slot in the wheel
+    /// @return false if the event cannot be handled by the wheel
+    bool push(SlotIndex slot);
+    /// Remove a slot from the wheel
+    void erase(SlotIndex slot);
+    /// Remove all slots and reset the wheel
+    /// @param tick the new tick of the wheel
+    /// @param time the current simulation time
+    void clear(::Smp::Duration tick, ::Smp::Duration time) noexcept;
+
+    /// Get the time of the next event, cascading upper levels if needed
+    /// @return the time of the next event or the maximal duration if empty
+    ::Smp::Duration next();
+
+    /// Collect the ids of the events scheduled at the given time.
+    /// The time must be the time returned by next().
+    void collect(::Smp::Duration time,
+                 std::vector<::Smp::Services::EventId> &ids) const;
+
+    /// Collect the first slots in scheduling order, without cascading
+    /// @param count the minimal number of slots to collect if available (a
+    /// whole bucket is collected at once)
+    /// @param slots the collected slots
+    void first(std::size_t count, std::vector<SlotIndex> &slots) const;
+
+  private:
+    static constexpr std::size_t levelBits = 8;
+    static constexpr std::size_t levelSize = 1 << levelBits;
+    static constexpr std::size_t levels = 4;
+    static constexpr std::uint64_t levelMask = levelSize - 1;
+
+    bool insert(SlotIndex slot, std::uint64_t tick);
+    void link(SlotIndex slot, std::uint32_t bucket) noexcept;
+    std::size_t findBucket(std::size_t level, std::size_t from) const noexcept;
+
+    std::deque<Slot> &_slots;
+    ::Smp::Duration _tick{0};
+    std::uint64_t _now{0}; // current tick of the wheel
+    std::size_t _size{0};
+    std::array<SlotIndex, levels * levelSize> _buckets;
+    std::array<std::uint64_t, levels * levelSize / 64> _occupied{};
+  };
+
+  // Lock-free queue of immediate events posted by several threads.
+  // Producers push an event with a single CAS on the head of an intrusive
+  // list, the consumer takes the whole list at once and gets the events in
+  // posting order.
+  class ImmediateEventQueue {
+  public:
+    ImmediateEventQueue() = default;
+    ImmediateEventQueue(const ImmediateEventQueue &) = delete;
+    ImmediateEventQueue &operator=(const ImmediateEventQueue &) = delete;
+    ~ImmediateEventQueue();
+
+    void push(::Smp::Services::EventId eventId,
+              const ::Smp::IEntryPoint *entryPoint);
+    bool empty() const noexcept {
+      return _head.load(std::memory_order_acquire) == nullptr;
+    }
+    /// Take all the queued events.
+    /// @param callback called with each event id and entry point, in posting
+    /// order
+    template <typename Callback> void drain(Callback &&callback) {
+      auto *node = reverse(_head.exchange(nullptr, std::memory_order_acquire));
+      while (node) {
+        auto *next = node->next;
+        callback(node->eventId, node->entryPoint);
+        delete node;
+        node = next;
+      }
+    }
+    /// Visit the queued events without taking them.
+    /// Must not be called concurrently with drain().
+    /// @param callback called with each event id and entry point, in reverse
+    /// posting order
+    template <typename Callback> void peek(Callback &&callback) const {
+      for (const auto *node = _head.load(std::memory_order_acquire); node;
+           node = node->next) {
+        callback(node->eventId, node->entryPoint);
+      }
+    }
+
+  private:
+    struct Node {
+      ::Smp::Services::EventId eventId;
+      const ::Smp::IEntryPoint *entryPoint;
+      Node *next;
+    };
+    static Node *reverse(Node *node) noexcept;
+    std::atomic<Node *> _head{nullptr};
+  };
+
   // scheduling table for zulu time events
   mutable std::mutex _zuluEventsTableMutex;
   std::map<::Smp::Duration, EventList> _zulu_events_table;
+  // protected by _zuluEventsTableMutex
+  ZuluDispatcherSettings _zuluSettings;
+  ZuluJitterHistogram _zuluJitter{};
+  std::atomic<bool> _zuluHighPrecision{false};
+  std::unique_ptr<ZuluTimer> _zuluTimer;
+
+  mutable std::mutex _eventsMutex; // protection for the events pool,
+                                   // _immediate_events and _events_table
+  // events pool
+  std::deque<Slot> _slots;
+  std::vector<SlotIndex> _freeSlots;
+  // Mapping between an EventId and its slot
+  std::unordered_map<::Smp::Services::EventId, SlotIndex> _events;
 
-  // Mapping between an EventId and internal data
-  mutable std::mutex _eventsMutex; // protection for _events, _immediate_events,
-                                   // _events_table and _lastEventId
   // scheduling table for simu/epoch/mission time events
-  std::map<::Smp::Duration, EventList> _events_table;
+  EventHeap _events_table{_slots};
+  // scheduling table for cyclic events aligned on a tick.
+  // mutable: looking for the next event may cascade the wheel
+  mutable TimingWheel _timingWheel{_slots};
+  // rate groups of cyclic events
+  std::vector<RateGroup> _rateGroups;
+  std::vector<std::uint32_t> _freeRateGroups;
+  bool _rateGroupCoalescing{false};
 
   // immediate events  table
   EventList _immediate_events;
-  std::map<::Smp::Services::EventId, Event> _events;
-  ::Smp::Services::EventId _lastEventId{-1};
+  // immediate events posted but not yet in the events pool
+  ImmediateEventQueue _immediateEventQueue;
+  std::atomic<::Smp::Services::EventId> _lastEventId{-1};
+
+  // events scheduled at the current simulation time, being executed
+  std::vector<::Smp::Services::EventId> _pendingEvents;
+
+  // execution group of the entry points
+  std::unordered_map<const ::Smp::IEntryPoint *, ::Smp::UInt32>
+      _executionGroups;
+  // events of the current parallel segment ordered by group
+  std::vector<std::pair<::Smp::UInt32, ::Smp::Services::EventId>>
+      _parallelEvents;
+  // boundaries of the groups in _parallelEvents
+  std::vector<std::size_t> _parallelGroups;
+  // number of threads requested, applied between two simulation times
+  std::atomic<std::size_t> _executionThreads{0};
+  std::unique_ptr<ExecutionPool> _executionPool; // protected by _execMutex
 
   // The current EventId that is being executed
   ::Smp::Services::EventId _currentEventId{-1};
@@ -414,6 +940,7 @@ private:
 
   enum class Status { Running, Hold };
   std::atomic<double> _targetSpeed{100.};
+  std::atomic<bool> _freeRunning{false};
   std::atomic<Status> _simulationStatus;
   bool _terminate{};
 
@@ -440,9 +967,146 @@ private:
   MovingAverage _load;
   MovingAverage _speed;
 
+  ::Smp::Bool get_FreeRunning() override;
+  void set_FreeRunning(::Smp::Bool value) override;
+  ::Smp::Bool get_Profiling() override;
+  void set_Profiling(::Smp::Bool value) override;
+  ::Smp::Float64 get_Load() override;
+  ::Smp::Float64 get_Speed() override;
+  ::Smp::Int32 get_OverrunPolicy() override;
+  void set_OverrunPolicy(::Smp::Int32 value) override;
+  ::Smp::Duration get_OverrunTolerance() override;
+  void set_OverrunTolerance(::Smp::Duration value) override;
+  ::Smp::Int64 get_OverrunCount() override;
+  ::Smp::Duration get_MaxLateness() override;
+
+  // real-time supervision
+  std::atomic<OverrunPolicy> _overrunPolicy{OverrunPolicy::CatchUp};
+  std::atomic<::Smp::Duration> _overrunTolerance{1'000'000};
+  std::atomic<::Smp::Int64> _overrunCount{0};
+  std::atomic<::Smp::Duration> _maxLateness{0};
+  ::Smp::Services::EventId _overrunEventId{-1};
+  // overruns not yet reported by a warning (scheduler thread only)
+  ::Smp::Int64 _unreportedOverruns{0};
+  ::Smp::Duration _unreportedLateness{0};
+  ::Smp::Duration _overrunWarningTime{0};
+
+  // last snapshot taken by Lookahead()
+  struct LookaheadItem {
+    ::Smp::Duration time;
+    ::Smp::Services::EventId eventId;
+    std::string entryPoint;
+  };
+  std::vector<LookaheadItem> _lookahead;
+  std::mutex _lookaheadMutex;
+  /// Get a copy of an item of the last lookahead snapshot
+  LookaheadItem GetLookaheadItem(::Smp::Int32 index);
+  // hold the simulation once the next simulation time is executed
+  std::atomic<bool> _holdAtNextTime{false};
+  // hold the simulation once this simulation time is executed
+  std::atomic<::Smp::Duration> _stopTime{
+      std::numeric_limits<::Smp::Duration>::max()};
+  // number of times the simulation entered the executing state
+  std::atomic<std::size_t> _runCount{0};
+  /// Run the simulation on the calling thread until it is held
+  /// @throws ::Smp::InvalidSimulatorState if the simulator did not start
+  ::Smp::Duration RunSynchronously();
+
+  /// Record a time step that missed its Zulu deadline and apply the overrun
+  /// policy. The warnings are aggregated: at most one per second.
+  /// @param lateness the lateness of the step on its own deadline
+  /// @param delay the accumulated delay on the Zulu time
+  /// @return false if the simulation is held
+  bool HandleOverrun(::Smp::Duration lateness, ::Smp::Duration &delay);
+
+  std::atomic<bool> _profiling{false};
+  std::unique_ptr<EntryPointProfiler> _profiler;
+  std::unique_ptr<EventTraceRecorder> _tracer;
+  std::string _traceDivergence;
+
+  /// Execute an entry point, and record its wall time if profiling or
+  /// tracing
+  /// @param eventId the event executing the entry point
+  /// @param entryPoint the entry point to execute
+  void ExecuteEntryPoint(::Smp::Services::EventId eventId,
+                         const ::Smp::IEntryPoint *entryPoint);
+
   /// Run the scheduler
   void InternalZuluRun();
 
+  /// Wait until a Zulu time, a new event or the termination of the thread
+  /// @param lck the lock of _zuluEventsTableMutex
+  /// @param zuluTime the Zulu time of the next event
+  void WaitZuluTime(std::unique_lock<std::mutex> &lck,
+                    ::Smp::DateTime zuluTime);
+
+  /// Wake up the thread dispatching the Zulu time events
+  void NotifyZuluThread();
+
+  /// Apply the CPU affinity and the scheduling policy to the Zulu thread
+  void ConfigureZuluThread();
+
+  /// Allocate a slot in the events pool
+  /// @param eventId the event id
+  /// @param event the event data
+  /// @return the index of the slot
+  SlotIndex AllocateSlot(::Smp::Services::EventId eventId, const Event &event);
+
+  /// Release a slot of the events pool and remove it from the scheduling table
+  /// @param slot the index of the slot
+  void ReleaseSlot(SlotIndex slot);
+
+  /// Insert a slot in the timing wheel or in the scheduling table
+  void Schedule(SlotIndex slot);
+
+  /// Remove a slot from the timing wheel or the scheduling table
+  void Unschedule(SlotIndex slot);
+
+  /// Update the position of a slot after its simulation time has changed
+  void Reschedule(SlotIndex slot);
+
+  /// Add a slot to a rate group, creating the group if needed
+  /// @param slot the index of the slot (not scheduled)
+  /// @return false if the event cannot be coalesced
+  bool JoinRateGroup(SlotIndex slot);
+
+  /// Remove a slot from its rate group
+  /// The member being executed is not scheduled: it is re-armed after its
+  /// execution as a standalone event.
+  /// @param slot the index of the slot
+  /// @param schedule true to schedule the slot as a standalone event
+  void LeaveRateGroup(SlotIndex slot, bool schedule);
+
+  /// Re-arm an event after its execution, or release it if it is not
+  /// repeated anymore
+  /// @param slot the index of the slot
+  void Rearm(SlotIndex slot);
+
+  /// Execute the members of a rate group
+  /// @param index the index of the rate group
+  /// @param lck the lock of _eventsMutex
+  void ExecuteRateGroup(std::uint32_t index, std::unique_lock<std::mutex> &lck);
+
+  /// Check if a slot is scheduled at a simulation time
+  static bool IsScheduled(const Slot &slot) noexcept;
+
+  /// Get the simulation time of the next scheduled event
+  /// @return the time of the next event or the maximal duration
+  ::Smp::Duration GetNextEventTime() const;
+
+  /// Find the slot of an event
+  /// @param eventId the event id
+  /// @return the index of the slot or InvalidSlot
+  SlotIndex FindSlot(::Smp::Services::EventId eventId) const;
+
+  /// Move the queued immediate events to the events pool
+  void CollectImmediateEvents();
+
+  /// Find the slot of an event, including the queued immediate events
+  /// @param eventId the event id
+  /// @return the index of the slot or InvalidSlot
+  SlotIndex FindEvent(::Smp::Services::EventId eventId);
+
   ::Smp::Services::EventId
   AddEvent(const ::Smp::IEntryPoint *entryPoint, ::Smp::Duration simulationTime,
            ::Smp::Duration time, ::Smp::Duration cycleTime, ::Smp::Int64 repeat,
@@ -454,17 +1118,28 @@ private:
 
   /// Execute a specific event
   /// @param eventId the event id to execute
-  void Execute(::Smp::Services::EventId eventId);
+  /// @param parallel true if the event is executed by the execution pool
+  void Execute(::Smp::Services::EventId eventId, bool parallel = false);
+
+  /// Execute the pending events from a given position, executing events of
+  /// different groups concurrently.
+  /// @param first the position of the first event in _pendingEvents
+  /// @return the position of the first un-executed event
+  std::size_t ExecuteParallelEvents(std::size_t first);
+
+  /// Create or release the execution pool according to the number of
+  /// execution threads requested by SetExecutionThreads()
+  void UpdateExecutionPool();
 
   /// Execute a specific event
   /// @param eventId the event id to execute
   void ExecuteZulu(::Smp::Services::EventId eventId);
 
-  /// Execute a list of events
-  /// @param events the vector of events to execute
+  /// Execute all events scheduled at a given simulation time
+  /// @param time the simulation time of the events to execute
   /// @return true if all events have been executed, false if hold immediate is
   /// requested and we have to exit
-  bool ExecuteEvents(EventList &events);
+  bool ExecuteEvents(::Smp::Duration time);
 
   /// Execute all immediate events
   /// @return true if all events have been executed, false if hold immediate is
@@ -23,19 +23,24 @@
 #include <Xsmp/Helper.h>
 #include <Xsmp/Persist.h>
 #include <Xsmp/Services/XsmpTimeKeeper.h>
+#include <limits>
 #include <mutex>
 
 namespace Xsmp::Services {
 
 void XsmpTimeKeeper::DoConnect(const ::Smp::ISimulator *simulator) const {
 
-  simulator->GetEventManager()->Subscribe(
+  // the time keeper is notified before any other subscriber
+  constexpr auto priority = std::numeric_limits<::Smp::Int32>::max();
+  ::Xsmp::Helper::Subscribe(
+      simulator->GetEventManager(),
       ::Smp::Services::IEventManager::SMP_PreSimTimeChangeId,
-      &PreSimTimeChange);
+      &PreSimTimeChange, priority);
 
-  simulator->GetEventManager()->Subscribe(
+  ::Xsmp::Helper::Subscribe(
+      simulator->GetEventManager(),
       ::Smp::Services::IEventManager::SMP_PostSimTimeChangeId,
-      &PostSimTimeChange);
+      &PostSimTimeChange, priority);
 }
 ::Smp::Duration XsmpTimeKeeper::GetSimulationTime() const {
   return _simulationTime.read().get();
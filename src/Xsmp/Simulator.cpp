@@ -498,6 +498,7 @@ void Simulator::Reconnect(::Smp::IComponent *root) {
   EmitGlobalEvent(::Smp::Services::IEventManager::SMP_LeaveStandbyId);
   _state = ::Smp::SimulatorStateKind::SSK_Reconnecting;
   EmitGlobalEvent(::Smp::Services::IEventManager::SMP_EnterReconnectingId);
+  ::Xsmp::Helper::InvalidatePaths();
 
   if (auto const *composite = dynamic_cast<::Smp::IComposite *>(root)) {
     recursive_action(composite, [this](::Smp::IComponent *cmp) {
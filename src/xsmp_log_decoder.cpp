@@ -0,0 +1,45 @@
+// Copyright 2023 THALES ALENIA SPACE FRANCE. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Render a log file written by a BinaryFileAppender as text.
+// Usage: xsmp_log_decoder <file> [conversionPattern]
+// The conversion pattern has the same syntax as the PatternLayout of the
+// XsmpLogger.properties file.
+
+#include <Xsmp/Services/XsmpLoggerLayout.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <file> [conversionPattern]\n";
+    return EXIT_FAILURE;
+  }
+  ::Xsmp::Services::BinaryLogReader reader{argv[1]};
+  if (!reader.IsValid()) {
+    std::cerr << "Could not read the binary log file " << argv[1] << '\n';
+    return EXIT_FAILURE;
+  }
+  const ::Xsmp::Services::PatternLayout layout{
+      argc == 3 ? ::Xsmp::Services::unescape(argv[2])
+                : std::string{::Xsmp::Services::PatternLayout::defaultPattern}};
+
+  ::Xsmp::Services::LogEntry entry;
+  while (reader.Read(entry)) {
+    layout.Append(std::cout, entry);
+  }
+  std::cout.flush();
+  return EXIT_SUCCESS;
+}
@@ -13,8 +13,12 @@
 // limitations under the License.
 
 #include <Smp/InvalidObjectName.h>
+#include <Xsmp/EntryPoint.h>
 #include <Xsmp/Helper.h>
+#include <Xsmp/Object.h>
 #include <gtest/gtest.h>
+#include <memory>
+#include <string>
 
 namespace Xsmp {
 
@@ -54,4 +58,38 @@ TEST(Helper, checkName) {
   EXPECT_NO_THROW(::Xsmp::Helper::checkName("[432]", nullptr));
 }
 
+TEST(Helper, GetCachedPath) {
+  EXPECT_EQ(::Xsmp::Helper::GetCachedPath(nullptr), "<null>");
+
+  Object parent{"parent"};
+  auto child = std::make_unique<Object>("child", "", &parent);
+  EXPECT_EQ(::Xsmp::Helper::GetCachedPath(child.get()), "<null>.parent.child");
+  EXPECT_EQ(::Xsmp::Helper::GetCachedPath(child.get()),
+            ::Xsmp::Helper::GetPath(child.get()));
+
+  // the cached path is evicted when an object is deleted
+  child.reset();
+  child = std::make_unique<Object>("other", "", &parent);
+  EXPECT_EQ(::Xsmp::Helper::GetCachedPath(child.get()), "<null>.parent.other");
+
+  Object item{"[0]", "", child.get()};
+  EXPECT_EQ(::Xsmp::Helper::GetPath(&item), "<null>.parent.other.[0]");
+}
+
+TEST(Helper, GetCachedPathReusedAddress) {
+  Object parent{"parent"};
+  auto *parentObject = static_cast<::Smp::IObject *>(&parent);
+
+  // the allocator is likely to reuse the address of a deleted entry point for
+  // the next one created with the same parent
+  for (auto name : {"ep1", "ep2", "ep3", "ep4"}) {
+    auto entryPoint =
+        std::make_unique<::Xsmp::EntryPoint>(name, "", parentObject, [] {});
+    EXPECT_EQ(::Xsmp::Helper::GetCachedPath(entryPoint.get()),
+              std::string("<null>.parent.") + name);
+    EXPECT_EQ(::Xsmp::Helper::GetCachedPath(entryPoint.get()),
+              ::Xsmp::Helper::GetPath(entryPoint.get()));
+  }
+}
+
 } // namespace Xsmp
@@ -12,20 +12,38 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <Smp/IEntryPointPublisher.h>
+#include <Smp/IPersist.h>
 #include <Smp/Services/EntryPointAlreadySubscribed.h>
 #include <Smp/Services/EntryPointNotSubscribed.h>
 #include <Smp/Services/EventId.h>
 #include <Smp/Services/IEventManager.h>
+#include <Smp/Services/IScheduler.h>
 #include <Smp/Services/InvalidEventId.h>
 #include <Smp/Services/InvalidEventName.h>
+#include <Smp/SimulatorStateKind.h>
 #include <Xsmp/Component.h>
 #include <Xsmp/EntryPoint.h>
 #include <Xsmp/EntryPointPublisher.h>
+#include <Xsmp/Helper.h>
+#include <Xsmp/Model.h>
+#include <Xsmp/Persist.h>
+#include <Xsmp/Persist/SmpIObject.h>
+#include <Xsmp/Persist/StdString.h>
+#include <Xsmp/Persist/StdUnorderedMap.h>
+#include <Xsmp/Persist/StdVector.h>
 #include <Xsmp/Simulator.h>
+#include <Xsmp/Storage.h>
+#include <atomic>
+#include <cstddef>
 #include <gtest/gtest.h>
 #include <initializer_list>
 #include <map>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace Xsmp::Services {
@@ -35,6 +53,12 @@ class TestEntryPointPublisher : public Xsmp::Component,
 public:
   using Xsmp::Component::Component;
 };
+/// a model whose entry points can be resolved from their path
+class TestModel : public Xsmp::Model,
+                  public virtual Xsmp::EntryPointPublisher {
+public:
+  using Xsmp::Model::Model;
+};
 } // namespace
 TEST(XsmpEventManager, QueryEventId) {
 
@@ -177,4 +201,294 @@ TEST(XsmpEventManager, ep) {
   EXPECT_THROW(sim.GetEventManager()->Emit(0xffff),
                ::Smp::Services::InvalidEventId);
 }
+
+TEST(XsmpEventManager, StoreRestore) {
+
+  // an entry point that can be resolved from its path
+  const auto getEntryPoint = [](Simulator &sim) {
+    auto *publisher =
+        dynamic_cast<::Smp::IEntryPointPublisher *>(sim.GetScheduler());
+    return publisher ? publisher->GetEntryPoint("HoldEvent") : nullptr;
+  };
+
+  Storage storage;
+  ::Smp::Services::EventId eventId = -1;
+  {
+    Simulator sim;
+    sim.LoadLibrary("xsmp_services");
+    auto *eventManager = dynamic_cast<::Smp::IPersist *>(sim.GetEventManager());
+    ASSERT_TRUE(eventManager);
+    const auto *ep = getEntryPoint(sim);
+    ASSERT_TRUE(ep);
+    sim.GetEventManager()->QueryEventId("event1");
+    eventId = sim.GetEventManager()->QueryEventId("event2");
+    sim.GetEventManager()->Subscribe(eventId, ep);
+    eventManager->Store(&storage);
+  }
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  auto *eventManager = dynamic_cast<::Smp::IPersist *>(sim.GetEventManager());
+  ASSERT_TRUE(eventManager);
+  // the ids of the restored events replace the current ones
+  sim.GetEventManager()->QueryEventId("event2");
+  eventManager->Restore(&storage);
+
+  EXPECT_EQ(sim.GetEventManager()->QueryEventId("event2"), eventId);
+  EXPECT_EQ(sim.GetEventManager()->QueryEventId("event3"), eventId + 1);
+  EXPECT_THROW(sim.GetEventManager()->Subscribe(eventId, getEntryPoint(sim)),
+               ::Smp::Services::EntryPointAlreadySubscribed);
+  EXPECT_NO_THROW(
+      sim.GetEventManager()->Unsubscribe(eventId, getEntryPoint(sim)));
+}
+
+TEST(XsmpEventManager, RestoreStaleEvents) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  auto *eventManager = sim.GetEventManager();
+  auto *persist = dynamic_cast<::Smp::IPersist *>(eventManager);
+  ASSERT_TRUE(persist);
+  const auto staleId = eventManager->QueryEventId("stale");
+
+  // a checkpoint that does not contain the id of the stale event
+  Storage storage;
+  std::unordered_map<std::string, ::Smp::Services::EventId> events{
+      {"event", staleId + 1}};
+  std::unordered_map<::Smp::Services::EventId,
+                     std::vector<const ::Smp::IEntryPoint *>>
+      subscriptions;
+  ::Xsmp::Persist::Store(&sim, eventManager, &storage, events, subscriptions);
+  persist->Restore(&storage);
+
+  EXPECT_EQ(eventManager->QueryEventId("event"), staleId + 1);
+  EXPECT_THROW(eventManager->Emit(staleId), ::Smp::Services::InvalidEventId);
+  // the pre-defined events are not in the checkpoint either
+  using ::Smp::Services::IEventManager;
+  EXPECT_THROW(eventManager->Emit(IEventManager::SMP_LeaveConnectingId),
+               ::Smp::Services::InvalidEventId);
+}
+
+TEST(XsmpEventManager, ManyEvents) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  auto *eventManager = sim.GetEventManager();
+  ASSERT_TRUE(eventManager);
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+
+  // the event table grows beyond its first chunks
+  static constexpr int count = 100000;
+  ::Smp::Services::EventId last = 0;
+  for (int i = 0; i < count; ++i) {
+    last = eventManager->QueryEventId(("event" + std::to_string(i)).c_str());
+  }
+  EXPECT_EQ(eventManager->QueryEventId("event0") + count - 1, last);
+  const auto lastName = "event" + std::to_string(count - 1);
+  EXPECT_EQ(eventManager->QueryEventId(lastName.c_str()), last);
+
+  int executed = 0;
+  ::Xsmp::EntryPoint ep{"ep", "", &entryPoints, [&]() { ++executed; }};
+  eventManager->Subscribe(last, &ep);
+  eventManager->Emit(last);
+  EXPECT_EQ(executed, 1);
+  EXPECT_THROW(eventManager->Emit(last + 1), ::Smp::Services::InvalidEventId);
+}
+
+TEST(XsmpEventManager, ConcurrentSubscriptions) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  auto *eventManager = sim.GetEventManager();
+  ASSERT_TRUE(eventManager);
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+
+  const auto eventId = eventManager->QueryEventId("ConcurrentEvent");
+  std::atomic<int> count1{0};
+  std::atomic<int> count2{0};
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints, [&]() { ++count1; }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints, [&]() { ++count2; }};
+  eventManager->Subscribe(eventId, &ep1);
+
+  // an emission uses the snapshot of the subscribers at the time of the call,
+  // the replaced snapshots are not released while an emission reads them
+  static constexpr int iterations = 1000;
+  std::thread subscriber{[&] {
+    for (int i = 0; i < iterations; ++i) {
+      eventManager->Subscribe(eventId, &ep2);
+      eventManager->Unsubscribe(eventId, &ep2);
+      ::Xsmp::Helper::FlushEvents(eventManager);
+    }
+  }};
+  for (int i = 0; i < iterations; ++i) {
+    eventManager->Emit(eventId);
+  }
+  subscriber.join();
+
+  EXPECT_EQ(count1, iterations);
+  EXPECT_LE(count2, iterations);
+  eventManager->Emit(eventId);
+  EXPECT_EQ(count1, iterations + 1);
+}
+
+TEST(XsmpEventManager, AsynchronousEmit) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  auto *eventManager = sim.GetEventManager();
+  ASSERT_TRUE(eventManager);
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+
+  const auto eventId1 = eventManager->QueryEventId("AsyncEvent1");
+  const auto eventId2 = eventManager->QueryEventId("AsyncEvent2");
+  std::mutex mutex;
+  std::vector<int> results1;
+  std::atomic<int> count2{0};
+  std::atomic<bool> running2{false};
+  std::atomic<bool> overlap{false};
+  const auto caller = std::this_thread::get_id();
+  std::atomic<bool> inCaller{false};
+  const auto push = [&](int value) {
+    inCaller = inCaller || std::this_thread::get_id() == caller;
+    const std::scoped_lock lck{mutex};
+    results1.push_back(value);
+  };
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints, [&]() { push(1); }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints, [&]() { push(2); }};
+  ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints, [&]() {
+                           overlap = overlap || running2.exchange(true);
+                           std::this_thread::yield();
+                           ++count2;
+                           running2 = false;
+                         }};
+  eventManager->Subscribe(eventId2, &ep3);
+
+  // more emissions than the bound of the queue, each one with the
+  // subscribers at the time of the call
+  static constexpr int iterations = 3000;
+  for (int i = 0; i < iterations; ++i) {
+    auto *ep = i % 2 ? &ep2 : &ep1;
+    eventManager->Subscribe(eventId1, ep);
+    eventManager->Emit(eventId1, false);
+    eventManager->Unsubscribe(eventId1, ep);
+    eventManager->Emit(eventId2, false);
+  }
+  ::Xsmp::Helper::FlushEvents(eventManager);
+
+  EXPECT_FALSE(inCaller);
+  EXPECT_FALSE(overlap);
+  EXPECT_EQ(count2, iterations);
+  // the emissions of an event are executed in order
+  ASSERT_EQ(results1.size(), static_cast<std::size_t>(iterations));
+  for (std::size_t i = 0; i < results1.size(); ++i) {
+    EXPECT_EQ(results1[i], i % 2 ? 2 : 1);
+  }
+
+  // a synchronous emission is executed by the caller
+  eventManager->Subscribe(eventId1, &ep1);
+  eventManager->Emit(eventId2, false);
+  eventManager->Emit(eventId1);
+  EXPECT_TRUE(inCaller);
+  ::Xsmp::Helper::FlushEvents(eventManager);
+  EXPECT_EQ(count2, iterations + 1);
+  EXPECT_EQ(results1.size(), static_cast<std::size_t>(iterations + 1));
+}
+
+TEST(XsmpEventManager, SubscriberPriority) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  auto *eventManager = sim.GetEventManager();
+  ASSERT_TRUE(eventManager);
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+
+  const auto eventId = eventManager->QueryEventId("PriorityEvent");
+  std::vector<int> results;
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints,
+                         [&]() { results.push_back(1); }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints,
+                         [&]() { results.push_back(2); }};
+  ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints, [&]() {
+                           results.push_back(3);
+                           throw std::runtime_error{"ep3 failed"};
+                         }};
+  ::Xsmp::EntryPoint ep4{"ep4", "", &entryPoints,
+                         [&]() { results.push_back(4); }};
+
+  eventManager->Subscribe(eventId, &ep1);
+  ::Xsmp::Helper::Subscribe(eventManager, eventId, &ep2, 10);
+  ::Xsmp::Helper::Subscribe(eventManager, eventId, &ep3, -1);
+  ::Xsmp::Helper::Subscribe(eventManager, eventId, &ep4, 0);
+  EXPECT_THROW(::Xsmp::Helper::Subscribe(eventManager, eventId, &ep4, 5),
+               ::Smp::Services::EntryPointAlreadySubscribed);
+
+  // by decreasing priority then by subscription order, a failing entry point
+  // does not prevent the others from being executed
+  eventManager->Emit(eventId);
+  std::vector<int> expected = {2, 1, 4, 3};
+  EXPECT_EQ(results, expected);
+  EXPECT_EQ(sim.GetState(), ::Smp::SimulatorStateKind::SSK_Aborting);
+
+  results.clear();
+  eventManager->Unsubscribe(eventId, &ep2);
+  eventManager->Unsubscribe(eventId, &ep3);
+  ::Xsmp::Helper::Subscribe(eventManager, eventId, &ep2, -10);
+  eventManager->Emit(eventId);
+  expected = {1, 4, 2};
+  EXPECT_EQ(results, expected);
+}
+
+TEST(XsmpEventManager, StoreRestorePriority) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  auto *eventManager = sim.GetEventManager();
+  auto *persist = dynamic_cast<::Smp::IPersist *>(eventManager);
+  ASSERT_TRUE(persist);
+  auto *entryPoints = new TestModel{"entryPoints", "", &sim};
+  sim.AddModel(entryPoints);
+
+  const auto eventId = eventManager->QueryEventId("PriorityEvent");
+  std::vector<int> results;
+  ::Xsmp::EntryPoint ep1{"ep1", "", entryPoints,
+                         [&]() { results.push_back(1); }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", entryPoints,
+                         [&]() { results.push_back(2); }};
+  eventManager->Subscribe(eventId, &ep1);
+  ::Xsmp::Helper::Subscribe(eventManager, eventId, &ep2, 10);
+
+  Storage storage;
+  constexpr ::Smp::Int32 next = 42;
+  persist->Store(&storage);
+  ::Xsmp::Persist::Store(&sim, &storage, next);
+  eventManager->Unsubscribe(eventId, &ep1);
+  eventManager->Unsubscribe(eventId, &ep2);
+  persist->Restore(&storage);
+  ::Smp::Int32 value = 0;
+  ::Xsmp::Persist::Restore(&sim, &storage, value);
+  EXPECT_EQ(value, next);
+  eventManager->Emit(eventId);
+  std::vector<int> expected = {2, 1};
+  EXPECT_EQ(results, expected);
+
+  // a checkpoint of the initial layout, without version nor priorities: the
+  // name map, then the subscriber map
+  std::unordered_map<std::string, ::Smp::Services::EventId> events{
+      {"PriorityEvent", eventId}};
+  std::unordered_map<::Smp::Services::EventId,
+                     std::vector<const ::Smp::IEntryPoint *>>
+      subscriptions{{eventId, {&ep1, &ep2}}};
+  ::Xsmp::Persist::Store(&sim, eventManager, &storage, events, subscriptions);
+  ::Xsmp::Persist::Store(&sim, &storage, next);
+  persist->Restore(&storage);
+  value = 0;
+  ::Xsmp::Persist::Restore(&sim, &storage, value);
+  EXPECT_EQ(value, next);
+
+  // the priorities are restored to 0: subscription order
+  results.clear();
+  eventManager->Emit(eventId);
+  expected = {1, 2};
+  EXPECT_EQ(results, expected);
+}
 } // namespace Xsmp::Services
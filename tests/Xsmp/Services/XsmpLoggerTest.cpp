@@ -14,9 +14,19 @@
 
 #include <Smp/PrimitiveTypes.h>
 #include <Smp/Services/ILogger.h>
+#include <Xsmp/Helper.h>
+#include <Xsmp/Services/XsmpLoggerLayout.h>
 #include <Xsmp/Simulator.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace Xsmp::Services {
 TEST(XsmpLogger, QueryLogMessageKind) {
@@ -57,4 +67,328 @@ TEST(XsmpLogger, QueryLogMessageKind) {
   }
 }
 
+TEST(XsmpLogger, LogMessageKindNames) {
+  {
+    std::ofstream properties{"XsmpLogger.properties"};
+    properties << "log.rootLogger = file\n"
+               << "log.appender.file = FileAppender\n"
+               << "log.appender.file.File = XsmpLoggerTest.log\n"
+               << "log.appender.file.levels = kind199, <unknown: 1000>\n"
+               << "log.appender.file.layout.conversionPattern = %k:%m%n\n";
+  }
+  {
+    Simulator sim;
+    sim.LoadLibrary("xsmp_services");
+    std::remove("XsmpLogger.properties");
+    auto *logger = sim.GetLogger();
+    // the kinds are stored in several chunks
+    ::Smp::Services::LogMessageKind kind = 0;
+    for (int i = 0; i < 200; ++i) {
+      kind = logger->QueryLogMessageKind(("kind" + std::to_string(i)).c_str());
+    }
+    EXPECT_EQ(logger->QueryLogMessageKind("kind199"), kind);
+    logger->Log(logger, "interned", kind);
+    logger->Log(logger, "unknown", 1000);
+  }
+  std::ostringstream content;
+  content << std::ifstream{"XsmpLoggerTest.log"}.rdbuf();
+  EXPECT_EQ(content.str(), "kind199:interned\n<unknown: 1000>:unknown\n");
+  std::remove("XsmpLoggerTest.log");
+}
+
+TEST(XsmpLogger, IsLogEnabled) {
+  {
+    std::ofstream properties{"XsmpLogger.properties"};
+    properties << "log.rootLogger = errors\n"
+               << "log.appender.errors = ConsoleAppender\n"
+               << "log.appender.errors.levels = Error, Custom\n";
+  }
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  std::remove("XsmpLogger.properties");
+
+  auto *logger = sim.GetLogger();
+  EXPECT_TRUE(::Xsmp::Helper::IsLogEnabled(
+      logger, logger, ::Smp::Services::ILogger::LMK_Error));
+  EXPECT_FALSE(::Xsmp::Helper::IsLogEnabled(
+      logger, logger, ::Smp::Services::ILogger::LMK_Debug));
+  EXPECT_FALSE(::Xsmp::Helper::IsLogEnabled(
+      logger, logger, ::Smp::Services::ILogger::LMK_Event));
+
+  EXPECT_TRUE(::Xsmp::Helper::IsLogEnabled(
+      logger, logger, logger->QueryLogMessageKind("Custom")));
+  EXPECT_FALSE(::Xsmp::Helper::IsLogEnabled(
+      logger, logger, logger->QueryLogMessageKind("Other")));
+
+  // unknown kinds are not filtered
+  EXPECT_TRUE(::Xsmp::Helper::IsLogEnabled(logger, logger, 1000));
+
+  // a disabled kind is silently discarded
+  logger->Log(logger, "discarded", ::Smp::Services::ILogger::LMK_Debug);
+
+  EXPECT_FALSE(::Xsmp::Helper::IsLogEnabled(
+      nullptr, nullptr, ::Smp::Services::ILogger::LMK_Error));
+}
+
+TEST(XsmpLogger, IsLogEnabledByDefault) {
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  auto *logger = sim.GetLogger();
+  EXPECT_TRUE(::Xsmp::Helper::IsLogEnabled(
+      logger, logger, ::Smp::Services::ILogger::LMK_Debug));
+  EXPECT_TRUE(::Xsmp::Helper::IsLogEnabled(
+      logger, logger, logger->QueryLogMessageKind("Custom")));
+}
+
+namespace {
+// log messages from several threads and return the written lines
+std::vector<std::string> LogConcurrently(const std::string &overflowPolicy,
+                                         int threadCount, int messageCount,
+                                         const std::string &bufferSize = "16") {
+  {
+    std::ofstream properties{"XsmpLogger.properties"};
+    properties << "log.rootLogger = file\n"
+               << "log.bufferSize = " << bufferSize << "\n"
+               << "log.overflowPolicy = " << overflowPolicy << "\n"
+               << "log.appender.file = FileAppender\n"
+               << "log.appender.file.File = XsmpLoggerTest.log\n"
+               << "log.appender.file.layout = SimpleLayout\n"
+               << "log.appender.file.levels = Concurrent, Warning\n";
+  }
+  {
+    Simulator sim;
+    sim.LoadLibrary("xsmp_services");
+    std::remove("XsmpLogger.properties");
+    auto *logger = sim.GetLogger();
+    const auto kind = logger->QueryLogMessageKind("Concurrent");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+      threads.emplace_back([logger, kind, messageCount, i] {
+        const auto msg = "message from thread " + std::to_string(i);
+        for (int j = 0; j < messageCount; ++j) {
+          logger->Log(logger, msg.c_str(), kind);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+  std::vector<std::string> lines;
+  {
+    std::ifstream log{"XsmpLoggerTest.log"};
+    for (std::string line; std::getline(log, line);) {
+      lines.push_back(line);
+    }
+  }
+  std::remove("XsmpLoggerTest.log");
+  return lines;
+}
+} // namespace
+
+TEST(XsmpLogger, ConcurrentLog) {
+  constexpr int threadCount = 8;
+  constexpr int messageCount = 1000;
+
+  // no message is lost when the producers wait for the logger thread
+  auto lines = LogConcurrently("block", threadCount, messageCount);
+  EXPECT_EQ(std::count_if(lines.begin(), lines.end(),
+                          [](const std::string &line) {
+                            return line.find("message from thread ") !=
+                                   std::string::npos;
+                          }),
+            threadCount * messageCount);
+
+  // each message is either written or reported as dropped
+  lines = LogConcurrently("dropOldest", threadCount, messageCount);
+  std::size_t count = 0;
+  for (const auto &line : lines) {
+    if (line.find("message from thread ") != std::string::npos) {
+      ++count;
+    } else if (line.find(" dropped") != std::string::npos) {
+      count += std::stoul(line.substr(line.rfind('\t') + 1));
+    }
+  }
+  EXPECT_EQ(count, static_cast<std::size_t>(threadCount * messageCount));
+}
+
+TEST(XsmpLogger, BufferSizeLimits) {
+  // the sizes too large or negative are replaced by a bounded size
+  for (const auto *bufferSize :
+       {"1000000000000", "100000000000000000000", "-1"}) {
+    const auto lines = LogConcurrently("block", 2, 100, bufferSize);
+    EXPECT_EQ(std::count_if(lines.begin(), lines.end(),
+                            [](const std::string &line) {
+                              return line.find("message from thread ") !=
+                                     std::string::npos;
+                            }),
+              200)
+        << bufferSize;
+  }
+}
+
+TEST(XsmpLogger, BinaryFileAppender) {
+  {
+    std::ofstream properties{"XsmpLogger.properties"};
+    properties << "log.rootLogger = binary\n"
+               << "log.appender.binary = BinaryFileAppender\n"
+               << "log.appender.binary.File = XsmpLoggerTest.xlog\n"
+               << "log.appender.binary.levels = Binary\n";
+  }
+  {
+    Simulator sim;
+    sim.LoadLibrary("xsmp_services");
+    std::remove("XsmpLogger.properties");
+    auto *logger = sim.GetLogger();
+    const auto kind = logger->QueryLogMessageKind("Binary");
+    logger->Log(logger, "first message", kind);
+    logger->Log(sim.GetEventManager(), "second message", kind);
+    logger->Log(logger, "", kind);
+  }
+
+  BinaryLogReader reader{"XsmpLoggerTest.xlog"};
+  ASSERT_TRUE(reader.IsValid());
+  LogEntry entry;
+  ASSERT_TRUE(reader.Read(entry));
+  EXPECT_EQ(entry.msg, "first message");
+  EXPECT_EQ(entry.kind, "Binary");
+  const auto loggerPath = entry.sender;
+  ASSERT_TRUE(reader.Read(entry));
+  EXPECT_EQ(entry.msg, "second message");
+  EXPECT_EQ(entry.kind, "Binary");
+  EXPECT_NE(entry.sender, loggerPath);
+  ASSERT_TRUE(reader.Read(entry));
+  EXPECT_EQ(entry.msg, "");
+  EXPECT_EQ(entry.sender, loggerPath);
+  EXPECT_FALSE(reader.Read(entry));
+
+  // the entries are rendered with a PatternLayout
+  BinaryLogReader decoder{"XsmpLoggerTest.xlog"};
+  const PatternLayout layout{"%k:%m%n"};
+  std::ostringstream text;
+  while (decoder.Read(entry)) {
+    layout.Append(text, entry);
+  }
+  EXPECT_EQ(text.str(), "Binary:first message\nBinary:second message\n"
+                        "Binary:\n");
+
+  std::remove("XsmpLoggerTest.xlog");
+  EXPECT_FALSE(BinaryLogReader{"XsmpLoggerTest.xlog"}.IsValid());
+}
+
+TEST(XsmpLogger, FileAppenderRollover) {
+  {
+    std::ofstream properties{"XsmpLogger.properties"};
+    properties << "log.rootLogger = file\n"
+               << "log.appender.file = FileAppender\n"
+               << "log.appender.file.File = XsmpLoggerTest.log\n"
+               << "log.appender.file.levels = Rolling\n"
+               << "log.appender.file.layout.conversionPattern = %m%n\n"
+               << "log.appender.file.BufferSize = 32\n"
+               << "log.appender.file.MaxFileSize = 100\n"
+               << "log.appender.file.MaxBackupIndex = 2\n";
+  }
+  {
+    Simulator sim;
+    sim.LoadLibrary("xsmp_services");
+    std::remove("XsmpLogger.properties");
+    auto *logger = sim.GetLogger();
+    const auto kind = logger->QueryLogMessageKind("Rolling");
+    // 30 entries of 11 bytes: 9 entries per file
+    for (int i = 10; i < 40; ++i) {
+      logger->Log(logger, ("message " + std::to_string(i)).c_str(), kind);
+    }
+  }
+  const auto read = [](const std::string &fileName) {
+    std::ifstream file{fileName};
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+  };
+  EXPECT_EQ(read("XsmpLoggerTest.log"),
+            "message 37\nmessage 38\nmessage 39\n");
+  const auto backup1 = read("XsmpLoggerTest.log.1");
+  EXPECT_EQ(backup1.size(), 99U);
+  EXPECT_EQ(backup1.substr(0, 11), "message 28\n");
+  const auto backup2 = read("XsmpLoggerTest.log.2");
+  EXPECT_EQ(backup2.size(), 99U);
+  EXPECT_EQ(backup2.substr(0, 11), "message 19\n");
+  EXPECT_FALSE(std::ifstream{"XsmpLoggerTest.log.3"}.is_open());
+
+  std::remove("XsmpLoggerTest.log");
+  std::remove("XsmpLoggerTest.log.1");
+  std::remove("XsmpLoggerTest.log.2");
+}
+
+TEST(XsmpLogger, PathFilter) {
+  {
+    std::ofstream properties{"XsmpLogger.properties"};
+    properties << "log.rootLogger = glob, regex\n"
+               << "log.appender.glob = FileAppender\n"
+               << "log.appender.glob.File = XsmpLoggerTest.glob.log\n"
+               << "log.appender.glob.levels = Filtered\n"
+               << "log.appender.glob.layout.conversionPattern = %m%n\n"
+               << "log.appender.glob.pathPattern = /unknown*, */Xsmp?ogger\n"
+               << "log.appender.regex = FileAppender\n"
+               << "log.appender.regex.File = XsmpLoggerTest.regex.log\n"
+               << "log.appender.regex.levels = Filtered\n"
+               << "log.appender.regex.layout.conversionPattern = %m%n\n"
+               << "log.appender.regex.path = .*EventManager\n";
+  }
+  {
+    Simulator sim;
+    sim.LoadLibrary("xsmp_services");
+    std::remove("XsmpLogger.properties");
+    auto *logger = sim.GetLogger();
+    const auto kind = logger->QueryLogMessageKind("Filtered");
+    // the second messages use the cached decisions
+    for (int i = 0; i < 2; ++i) {
+      logger->Log(logger, "logger", kind);
+      logger->Log(sim.GetEventManager(), "event manager", kind);
+    }
+  }
+  const auto read = [](const std::string &fileName) {
+    std::ifstream file{fileName};
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+  };
+  EXPECT_EQ(read("XsmpLoggerTest.glob.log"), "logger\nlogger\n");
+  EXPECT_EQ(read("XsmpLoggerTest.regex.log"),
+            "event manager\nevent manager\n");
+
+  std::remove("XsmpLoggerTest.glob.log");
+  std::remove("XsmpLoggerTest.regex.log");
+}
+
+TEST(XsmpLogger, PatternLayout) {
+  // 2000-01-01 12:00:00 is the origin of the SMP date times
+  const LogEntry entry{"/sender",
+                       "message",
+                       "Information",
+                       ::Xsmp::DateTime{1'500'000'000},
+                       ::Xsmp::Duration{-3'723'000'000'123},
+                       ::Xsmp::DateTime{-1},
+                       ::Xsmp::Duration{36'000'000'000'005}};
+  const auto format = [&entry](std::string pattern) {
+    std::ostringstream stream;
+    PatternLayout{std::move(pattern)}.Append(stream, entry);
+    return stream.str();
+  };
+  EXPECT_EQ(format("%d{%F %T}%t%S%t%p%t%k%t%m%n"),
+            "2000-01-01 12:00:01.500000000\t-3723000000123\t/sender\t"
+            "Information\tmessage\n");
+  EXPECT_EQ(format("%E{%F %T}"), "2000-01-01 11:59:59.999999999");
+  EXPECT_EQ(format("%E{%F}|%E{%T}"), "2000-01-01|11:59:59.999999999");
+  EXPECT_EQ(format("%S{%T}|%M{%T}"), "-01:02:03.000000123|10:00:00.000000005");
+  EXPECT_EQ(format("%d{%Y}"), "2000");
+  EXPECT_EQ(format("%d|%E|%M"), "1500000000|-1|36000000000005");
+  EXPECT_EQ(format("%% %x %"), "% %x %");
+
+  std::ostringstream stream;
+  SimpleLayout{}.Append(stream, entry);
+  EXPECT_EQ(stream.str(), "-01:02:03.000000123\t/sender\tInformation\t"
+                          "message\n");
+}
+
 } // namespace Xsmp::Services
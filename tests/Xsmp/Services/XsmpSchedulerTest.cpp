@@ -13,8 +13,12 @@
 // limitations under the License.
 
 #include "Xsmp/Component.h"
+#include <Smp/Exception.h>
+#include <Smp/IProperty.h>
+#include <Smp/InvalidSimulatorState.h>
 #include <Smp/PrimitiveTypes.h>
 #include <Smp/Services/EventId.h>
+#include <Smp/Services/IEventManager.h>
 #include <Smp/Services/ITimeKeeper.h>
 #include <Smp/Services/InvalidCycleTime.h>
 #include <Smp/Services/InvalidEventId.h>
@@ -22,10 +26,22 @@
 #include <Smp/SimulatorStateKind.h>
 #include <Xsmp/Duration.h>
 #include <Xsmp/EntryPoint.h>
+#include <Xsmp/Helper.h>
 #include <Xsmp/Services/XsmpScheduler.h>
 #include <Xsmp/Simulator.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -37,6 +53,21 @@ class TestEntryPointPublisher : public Xsmp::Component,
 public:
   using Xsmp::Component::Component;
 };
+
+/// Wait until a condition holds, with a timeout generous enough for a loaded
+/// machine
+/// @return false on timeout
+template <typename Predicate> bool WaitUntil(Predicate &&predicate) {
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (!predicate()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  return true;
+}
 } // namespace
 TEST(XsmpScheduler, run) {
 
@@ -105,6 +136,310 @@ TEST_P(SpeedFixture, Speed) {
               static_cast<double>(5_ms));
 }
 
+TEST(XsmpScheduler, FreeRunning) {
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  // the slowest speed: 1s of simulation would last 100s
+  scheduler.SetTargetSpeed(0.01);
+  EXPECT_FALSE(scheduler.IsFreeRunning());
+
+  // enable the free running mode through the published property
+  auto *property = dynamic_cast<::Smp::IProperty *>(
+      ::Xsmp::Helper::Resolve(&scheduler, "FreeRunning"));
+  ASSERT_TRUE(property);
+  property->SetValue({::Smp::PrimitiveTypeKind::PTK_Bool, true});
+  EXPECT_TRUE(scheduler.IsFreeRunning());
+  EXPECT_TRUE(static_cast<bool>(property->GetValue()));
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::size_t count = 0;
+  ::Xsmp::EntryPoint ep{"ep", "", &entryPoints, [&] { ++count; }};
+  scheduler.AddSimulationTimeEvent(&ep, 0, 1_ms, -1);
+
+  auto zuluTime = sim.GetTimeKeeper()->GetZuluTime();
+  sim.Run(1_s);
+  EXPECT_EQ(sim.GetTimeKeeper()->GetSimulationTime(), 1_s);
+  EXPECT_EQ(count, 1001);
+  EXPECT_LT(sim.GetTimeKeeper()->GetZuluTime() - zuluTime, 1_s);
+
+  // back to a paced execution
+  scheduler.SetFreeRunning(false);
+  scheduler.SetTargetSpeed(1.0);
+  zuluTime = sim.GetTimeKeeper()->GetZuluTime() + 20_ms;
+  sim.Run(20_ms);
+  EXPECT_NEAR(static_cast<double>(zuluTime),
+              static_cast<double>(sim.GetTimeKeeper()->GetZuluTime()),
+              static_cast<double>(5_ms));
+}
+
+TEST(XsmpScheduler, Profiling) {
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetFreeRunning(true);
+  EXPECT_FALSE(scheduler.IsProfiling());
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints, [] {}};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints,
+                         [] {
+                           std::this_thread::sleep_for(
+                               std::chrono::microseconds{100});
+                         }};
+  scheduler.AddSimulationTimeEvent(&ep1, 0, 1_ms, -1);
+  scheduler.AddSimulationTimeEvent(&ep2, 0, 10_ms, -1);
+
+  // nothing is recorded while profiling is disabled
+  sim.Run(10_ms);
+  EXPECT_TRUE(scheduler.GetProfile().empty());
+
+  // enable the profiling through the published property
+  auto *property = dynamic_cast<::Smp::IProperty *>(
+      ::Xsmp::Helper::Resolve(&scheduler, "Profiling"));
+  ASSERT_TRUE(property);
+  property->SetValue({::Smp::PrimitiveTypeKind::PTK_Bool, true});
+  EXPECT_TRUE(scheduler.IsProfiling());
+
+  sim.Run(100_ms);
+  auto profile = scheduler.GetProfile();
+  ASSERT_EQ(profile.size(), 2);
+  // sorted by total execution time
+  EXPECT_EQ(profile[0].entryPoint, &ep2);
+  EXPECT_EQ(profile[0].count, 10);
+  EXPECT_EQ(profile[1].entryPoint, &ep1);
+  EXPECT_EQ(profile[1].count, 100);
+  for (const auto &entry : profile) {
+    EXPECT_LE(entry.min, entry.max);
+    EXPECT_LE(entry.max, entry.total);
+    EXPECT_EQ(std::accumulate(entry.histogram.begin(), entry.histogram.end(),
+                              ::Smp::UInt64{0}),
+              entry.count);
+  }
+  EXPECT_GE(profile[0].min, 100_us);
+
+  const auto directory = std::filesystem::temp_directory_path();
+  for (const auto *fileName : {"XsmpSchedulerProfile.csv",
+                               "XsmpSchedulerProfile.json"}) {
+    const auto path = (directory / fileName).string();
+    scheduler.DumpProfile(path.c_str());
+    std::ifstream is{path};
+    std::stringstream content;
+    content << is.rdbuf();
+    EXPECT_NE(content.str().find("entryPoints.ep1"), std::string::npos);
+    EXPECT_NE(content.str().find("entryPoints.ep2"), std::string::npos);
+    // the last bucket of the histogram includes all the longer executions
+    if (std::filesystem::path{path}.extension() == ".csv") {
+      EXPECT_NE(content.str().find(",<536870912us,>=1073741824us\n"),
+                std::string::npos);
+    }
+    is.close();
+    std::filesystem::remove(path);
+  }
+  EXPECT_THROW(scheduler.DumpProfile(
+                   (directory / "unknown" / "profile.csv").string().c_str()),
+               ::Smp::Exception);
+
+  scheduler.ResetProfile();
+  EXPECT_TRUE(scheduler.GetProfile().empty());
+  sim.Run(1_ms);
+  profile = scheduler.GetProfile();
+  ASSERT_EQ(profile.size(), 1);
+  EXPECT_EQ(profile[0].entryPoint, &ep1);
+  EXPECT_EQ(profile[0].path, "/entryPoints.ep1");
+  EXPECT_EQ(profile[0].count, 1);
+
+  // the path of an entry point deleted before the dump is still known
+  auto ep3 = std::make_unique<::Xsmp::EntryPoint>(
+      "ep3", "", static_cast<::Smp::IObject *>(&entryPoints), [] {});
+  scheduler.AddSimulationTimeEvent(ep3.get(), 0, 0, 0);
+  sim.Run(1_ms);
+  ep3.reset();
+  const auto path = (directory / "XsmpSchedulerDeletedProfile.json").string();
+  scheduler.DumpProfile(path.c_str());
+  std::ifstream is{path};
+  std::stringstream content;
+  content << is.rdbuf();
+  EXPECT_NE(content.str().find(R"("entryPoint": "/entryPoints.ep3")"),
+            std::string::npos);
+  is.close();
+  std::filesystem::remove(path);
+}
+
+TEST(XsmpScheduler, Trace) {
+  const auto directory = std::filesystem::temp_directory_path();
+  // run a scenario and record its trace
+  const auto record = [&directory](const char *fileName, bool swap) {
+    Simulator sim;
+    sim.LoadLibrary("xsmp_services");
+    sim.Connect();
+    auto &scheduler =
+        *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+    scheduler.SetFreeRunning(true);
+
+    TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+    ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints, [] {}};
+    ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints, [] {}};
+    ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints, [] {}};
+    scheduler.AddSimulationTimeEvent(&ep1, 0, 1_ms, -1);
+    scheduler.AddSimulationTimeEvent(swap ? &ep3 : &ep2, 2_ms, 0, 0);
+    scheduler.AddSimulationTimeEvent(swap ? &ep2 : &ep3, 2_ms, 0, 0);
+
+    const auto path = (directory / fileName).string();
+    EXPECT_FALSE(scheduler.IsTracing());
+    scheduler.StartTrace(path.c_str());
+    EXPECT_TRUE(scheduler.IsTracing());
+    sim.Run(3_ms);
+    scheduler.StopTrace();
+    EXPECT_FALSE(scheduler.IsTracing());
+    EXPECT_EQ(scheduler.GetTraceDropCount(), 0);
+    return path;
+  };
+
+  const auto reference = record("XsmpSchedulerTrace1.bin", false);
+  const auto same = record("XsmpSchedulerTrace2.bin", false);
+  const auto swapped = record("XsmpSchedulerTrace3.bin", true);
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+
+  const auto records = scheduler.ReadTrace(reference.c_str());
+  // ep1 at 0, 1, 2 and 3ms, ep2 and ep3 at 2ms and the hold entry point
+  ASSERT_EQ(records.size(), 7);
+  EXPECT_EQ(records[0].simulationTime, 0);
+  EXPECT_EQ(records[0].entryPoint, "/entryPoints.ep1");
+  EXPECT_EQ(records[3].simulationTime, 2_ms);
+  EXPECT_EQ(records[3].entryPoint, "/entryPoints.ep2");
+  EXPECT_EQ(records[4].entryPoint, "/entryPoints.ep3");
+  for (std::size_t i = 1; i < records.size(); ++i) {
+    EXPECT_GE(records[i].zuluTime, records[i - 1].zuluTime);
+    EXPECT_GE(records[i].duration, 0);
+  }
+
+  EXPECT_STREQ(scheduler.CompareTrace(reference.c_str(), same.c_str()), "");
+  const std::string divergence =
+      scheduler.CompareTrace(reference.c_str(), swapped.c_str());
+  EXPECT_EQ(divergence.rfind("record 3: expected event ", 0), 0)
+      << divergence;
+  EXPECT_NE(divergence.find("(/entryPoints.ep2) at 2000000, got event "),
+            std::string::npos)
+      << divergence;
+
+  EXPECT_THROW(scheduler.ReadTrace(
+                   (directory / "unknown" / "trace.bin").string().c_str()),
+               ::Smp::Exception);
+  EXPECT_THROW(scheduler.StartTrace(
+                   (directory / "unknown" / "trace.bin").string().c_str()),
+               ::Smp::Exception);
+
+  for (const auto &path : {reference, same, swapped}) {
+    std::filesystem::remove(path);
+  }
+}
+
+TEST(XsmpScheduler, Overruns) {
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(1.0);
+  EXPECT_EQ(scheduler.GetOverrunPolicy(),
+            XsmpScheduler::OverrunPolicy::CatchUp);
+
+  // each step lasts 5ms for a budget of 2ms
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  ::Xsmp::EntryPoint ep{"ep", "", &entryPoints, [] {
+                          std::this_thread::sleep_for(
+                              std::chrono::milliseconds{5});
+                        }};
+  scheduler.AddSimulationTimeEvent(&ep, 0, 2_ms, -1);
+
+  // the lost time is accumulated, each step is late on its own deadline
+  sim.Run(20_ms);
+  EXPECT_GE(scheduler.GetOverrunCount(), 9);
+  EXPECT_GE(scheduler.GetMaxLateness(), 3_ms);
+  auto *property = dynamic_cast<::Smp::IProperty *>(
+      ::Xsmp::Helper::Resolve(&scheduler, "OverrunCount"));
+  ASSERT_TRUE(property);
+  EXPECT_EQ(static_cast<::Smp::Int64>(property->GetValue()),
+            scheduler.GetOverrunCount());
+
+  // the lost time is dropped at each step
+  scheduler.ResetOverruns();
+  EXPECT_EQ(scheduler.GetOverrunCount(), 0);
+  EXPECT_EQ(scheduler.GetMaxLateness(), 0);
+  property = dynamic_cast<::Smp::IProperty *>(
+      ::Xsmp::Helper::Resolve(&scheduler, "OverrunPolicy"));
+  ASSERT_TRUE(property);
+  property->SetValue({::Smp::PrimitiveTypeKind::PTK_Int32,
+                      static_cast<::Smp::Int32>(
+                          XsmpScheduler::OverrunPolicy::SkipToNow)});
+  EXPECT_EQ(scheduler.GetOverrunPolicy(),
+            XsmpScheduler::OverrunPolicy::SkipToNow);
+  EXPECT_THROW(property->SetValue({::Smp::PrimitiveTypeKind::PTK_Int32, 4}),
+               ::Smp::Exception);
+  sim.Run(20_ms);
+  EXPECT_GE(scheduler.GetOverrunCount(), 9);
+  EXPECT_GE(scheduler.GetMaxLateness(), 3_ms);
+
+  // the overruns are notified with an event
+  scheduler.SetOverrunPolicy(XsmpScheduler::OverrunPolicy::Emit);
+  std::size_t overruns = 0;
+  ::Xsmp::EntryPoint onOverrun{"onOverrun", "", &entryPoints,
+                               [&] { ++overruns; }};
+  sim.GetEventManager()->Subscribe(sim.GetEventManager()->QueryEventId(
+                                       XsmpScheduler::SchedulerOverrunEvent),
+                                   &onOverrun);
+  scheduler.ResetOverruns();
+  sim.Run(20_ms);
+  EXPECT_GE(overruns, 9);
+  EXPECT_EQ(static_cast<::Smp::Int64>(overruns),
+            scheduler.GetOverrunCount());
+
+  // the simulation is held at the first overrun
+  scheduler.SetOverrunPolicy(XsmpScheduler::OverrunPolicy::Hold);
+  scheduler.ResetOverruns();
+  const auto time = sim.GetTimeKeeper()->GetSimulationTime();
+  sim.Run(20_ms);
+  EXPECT_EQ(scheduler.GetOverrunCount(), 1);
+  EXPECT_EQ(sim.GetState(), ::Smp::SimulatorStateKind::SSK_Standby);
+  EXPECT_LT(sim.GetTimeKeeper()->GetSimulationTime(), time + 20_ms);
+}
+
+TEST(XsmpScheduler, CatchUpOverrun) {
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(1.0);
+  scheduler.SetOverrunTolerance(5_ms);
+
+  // only the first step lasts longer than its budget of 2ms
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  bool first = true;
+  ::Xsmp::EntryPoint ep{"ep", "", &entryPoints, [&first] {
+                          if (std::exchange(first, false)) {
+                            std::this_thread::sleep_for(
+                                std::chrono::milliseconds{20});
+                          }
+                        }};
+  scheduler.AddSimulationTimeEvent(&ep, 0, 2_ms, -1);
+
+  // the steps catching up the lost time are not overruns
+  sim.Run(40_ms);
+  EXPECT_EQ(scheduler.GetOverrunCount(), 1);
+  EXPECT_GE(scheduler.GetMaxLateness(), 15_ms);
+}
+
 TEST(XsmpScheduler, zulu_events) {
 
   Simulator sim;
@@ -161,6 +496,51 @@ TEST(XsmpScheduler, zulu_events) {
   EXPECT_EQ(results, expected);
 }
 
+TEST(XsmpScheduler, ZuluDispatcher) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+
+  Services::XsmpScheduler::ZuluDispatcherSettings settings;
+  settings.highPrecision = true;
+  settings.spinWindow = 50_us;
+  scheduler.SetZuluDispatcherSettings(settings);
+  EXPECT_EQ(scheduler.GetZuluDispatcherSettings().spinWindow, 50_us);
+#if defined(__linux__)
+  EXPECT_TRUE(scheduler.GetZuluDispatcherSettings().highPrecision);
+#endif
+  scheduler.ResetZuluJitterHistogram();
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::atomic<int> count{0};
+  ::Xsmp::EntryPoint ep{"ep", "", &entryPoints, [&] { ++count; }};
+
+  // 1 kHz zulu event
+  scheduler.AddZuluTimeEvent(&ep, sim.GetTimeKeeper()->GetZuluTime() + 1_ms,
+                             1_ms, 19);
+  EXPECT_TRUE(WaitUntil([&count] { return count == 20; }));
+
+  const auto jitterCount = [&scheduler] {
+    const auto histogram = scheduler.GetZuluJitterHistogram();
+    return std::accumulate(histogram.begin(), histogram.end(),
+                           ::Smp::UInt64{0});
+  };
+  EXPECT_TRUE(WaitUntil([&jitterCount] { return jitterCount() == 20; }));
+
+  // back to the default dispatcher
+  scheduler.SetZuluDispatcherSettings({});
+  EXPECT_FALSE(scheduler.GetZuluDispatcherSettings().highPrecision);
+  scheduler.AddZuluTimeEvent(&ep, sim.GetTimeKeeper()->GetZuluTime() + 1_ms,
+                             0, 0);
+  EXPECT_TRUE(WaitUntil([&count] { return count == 21; }));
+  sim.Exit();
+  // no execution beyond the repeat count
+  EXPECT_EQ(count, 21);
+}
+
 TEST(XsmpScheduler, EventTime) {
 
   Simulator sim;
@@ -268,4 +648,545 @@ TEST(XsmpScheduler, RemoveEvent) {
   EXPECT_NO_THROW(scheduler.RemoveEvent(id));
 }
 
+TEST(XsmpScheduler, CyclicEvents) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(100.0);
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::vector<int> results;
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints,
+                         [&] { results.push_back(1); }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints,
+                         [&] { results.push_back(2); }};
+  auto id1 = scheduler.AddSimulationTimeEvent(&ep1, 1_ms, 2_ms, -1);
+  ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints, [&] {
+                           results.push_back(3);
+                           scheduler.RemoveEvent(id1);
+                         }};
+  auto id2 = scheduler.AddSimulationTimeEvent(&ep2, 1_ms, 1_ms, -1);
+  scheduler.AddSimulationTimeEvent(&ep3, 2_ms, 0, 0);
+
+  sim.Run(4_ms);
+
+  EXPECT_EQ(sim.GetTimeKeeper()->GetSimulationTime(), 4_ms);
+  EXPECT_EQ(scheduler.GetNextScheduledEventTime(), 5_ms);
+  EXPECT_THROW(scheduler.RemoveEvent(id1), ::Smp::Services::InvalidEventId);
+  EXPECT_NO_THROW(scheduler.RemoveEvent(id2));
+
+  const std::vector<int> expected = {1, 2, 2, 3, 2, 2};
+  EXPECT_EQ(results, expected);
+}
+
+TEST(XsmpScheduler, RateGroups) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(100.0);
+  scheduler.SetRateGroupCoalescing(true);
+  EXPECT_TRUE(scheduler.IsRateGroupCoalescing());
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::vector<int> results;
+  ::Smp::Services::EventId id2 = -1;
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints,
+                         [&] { results.push_back(1); }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints, [&] {
+                           results.push_back(2);
+                           EXPECT_EQ(scheduler.GetCurrentEventId(), id2);
+                         }};
+  ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints,
+                         [&] { results.push_back(3); }};
+  ::Xsmp::EntryPoint ep4{"ep4", "", &entryPoints,
+                         [&] { results.push_back(4); }};
+
+  auto id1 = scheduler.AddSimulationTimeEvent(&ep1, 0, 1_ms, -1);
+  id2 = scheduler.AddSimulationTimeEvent(&ep2, 0, 1_ms, -1);
+  scheduler.AddSimulationTimeEvent(&ep4, 0, 2_ms, -1);
+  scheduler.AddSimulationTimeEvent(&ep3, 0, 1_ms, -1);
+  // not coalesced: not repeated forever
+  scheduler.AddSimulationTimeEvent(&ep4, 1_ms, 1_ms, 1);
+  EXPECT_EQ(scheduler.GetRateGroupCount(), 2);
+
+  // the members of a group are executed at the position of the first one
+  sim.Run(2_ms);
+  std::vector<int> expected = {1, 2, 3, 4, 1, 2, 3, 4, 1, 2, 3, 4, 4};
+  EXPECT_EQ(results, expected);
+
+  // ep2 leaves its group and the group is led by ep3
+  results.clear();
+  scheduler.SetEventCycleTime(id2, 2_ms);
+  scheduler.RemoveEvent(id1);
+  EXPECT_THROW(scheduler.RemoveEvent(id1), ::Smp::Services::InvalidEventId);
+  EXPECT_EQ(scheduler.GetRateGroupCount(), 2);
+  EXPECT_EQ(scheduler.GetNextScheduledEventTime(), 3_ms);
+  sim.Run(2_ms);
+  expected = {2, 3, 4, 3};
+  EXPECT_EQ(results, expected);
+
+  // the events are scheduled individually again
+  results.clear();
+  scheduler.SetRateGroupCoalescing(false);
+  EXPECT_EQ(scheduler.GetRateGroupCount(), 0);
+  sim.Run(1_ms);
+  expected = {2, 3};
+  EXPECT_EQ(results, expected);
+}
+
+TEST(XsmpScheduler, RateGroupMemberPeriod) {
+
+  // the members of a rate group behave as the events executed alone
+  for (const auto coalescing : {false, true}) {
+    SCOPED_TRACE(coalescing);
+    Simulator sim;
+    sim.LoadLibrary("xsmp_services");
+    sim.Connect();
+    auto &scheduler =
+        *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+    scheduler.SetTargetSpeed(100.0);
+    scheduler.SetRateGroupCoalescing(coalescing);
+
+    TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+    std::vector<::Smp::Duration> times1;
+    std::vector<::Smp::Duration> times2;
+    std::vector<::Smp::Duration> times3;
+    ::Smp::Services::EventId id1 = -1;
+    ::Smp::Services::EventId id2 = -1;
+    ::Smp::Services::EventId id3 = -1;
+    const auto now = [&sim] {
+      return sim.GetTimeKeeper()->GetSimulationTime();
+    };
+    // ep1 is already executed when ep2 changes its period: its next execution
+    // is scheduled with the previous period
+    ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints,
+                           [&] { times1.push_back(now()); }};
+    // ep2 changes its own period and the period of ep1
+    ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints, [&] {
+                             times2.push_back(now());
+                             if (times2.size() == 1) {
+                               scheduler.SetEventCycleTime(id1, 3_ms);
+                               scheduler.SetEventCycleTime(id2, 3_ms);
+                             }
+                           }};
+    // ep3 removes itself during its second execution
+    ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints, [&] {
+                             times3.push_back(now());
+                             if (times3.size() == 2) {
+                               scheduler.RemoveEvent(id3);
+                               EXPECT_EQ(scheduler.GetCurrentEventId(), id3);
+                               EXPECT_NO_THROW(
+                                   scheduler.SetEventCycleTime(id3, 2_ms));
+                               EXPECT_NO_THROW(
+                                   scheduler.SetEventRepeat(id3, 0));
+                             }
+                           }};
+    id1 = scheduler.AddSimulationTimeEvent(&ep1, 0, 1_ms, -1);
+    id2 = scheduler.AddSimulationTimeEvent(&ep2, 0, 1_ms, -1);
+    id3 = scheduler.AddSimulationTimeEvent(&ep3, 0, 1_ms, -1);
+    EXPECT_EQ(scheduler.GetRateGroupCount(), coalescing ? 1 : 0);
+
+    sim.Run(6_ms);
+    EXPECT_EQ(times1, (std::vector<::Smp::Duration>{0, 1_ms, 4_ms}));
+    EXPECT_EQ(times2, (std::vector<::Smp::Duration>{0, 3_ms, 6_ms}));
+    EXPECT_EQ(times3, (std::vector<::Smp::Duration>{0, 1_ms}));
+    EXPECT_THROW(scheduler.RemoveEvent(id3), ::Smp::Services::InvalidEventId);
+  }
+}
+
+TEST(XsmpScheduler, AddEvents) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(100.0);
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::vector<int> results;
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints,
+                         [&] { results.push_back(1); }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints,
+                         [&] { results.push_back(2); }};
+  ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints,
+                         [&] { results.push_back(3); }};
+
+  using ::Smp::Services::TimeKind;
+  auto *timeKeeper = sim.GetTimeKeeper();
+  const auto ids = scheduler.AddEvents({
+      {&ep1, 1_ms, 2_ms, 1, TimeKind::TK_SimulationTime},
+      {&ep2, timeKeeper->GetMissionTime() + 2_ms, 0, 0,
+       TimeKind::TK_MissionTime},
+      {&ep3, timeKeeper->GetEpochTime() + 1_ms, 0, 0, TimeKind::TK_EpochTime},
+      {&ep2, 1_ms, 1_ms, -1, TimeKind::TK_SimulationTime},
+  });
+  ASSERT_EQ(ids.size(), 4);
+  EXPECT_EQ(ids[1], ids[0] + 1);
+  EXPECT_EQ(ids[2], ids[1] + 1);
+  EXPECT_EQ(ids[3], ids[2] + 1);
+  EXPECT_EQ(scheduler.GetNextScheduledEventTime(), 1_ms);
+
+  // an invalid event: nothing is posted
+  EXPECT_THROW(scheduler.AddEvents({
+                   {&ep1, 1_ms, 0, 0, TimeKind::TK_SimulationTime},
+                   {&ep1, -1_ms, 0, 0, TimeKind::TK_SimulationTime},
+               }),
+               ::Smp::Services::InvalidEventTime);
+  EXPECT_THROW(scheduler.AddEvents({
+                   {&ep1, 1_ms, 0, 0, TimeKind::TK_SimulationTime},
+                   {&ep1, 1_ms, 0, 1, TimeKind::TK_SimulationTime},
+               }),
+               ::Smp::Services::InvalidCycleTime);
+  EXPECT_TRUE(scheduler.AddEvents({}).empty());
+
+  sim.Run(3_ms);
+  EXPECT_NO_THROW(scheduler.RemoveEvent(ids[3]));
+  EXPECT_THROW(scheduler.RemoveEvent(ids[0]), ::Smp::Services::InvalidEventId);
+
+  const std::vector<int> expected = {1, 3, 2, 2, 2, 1, 2};
+  EXPECT_EQ(results, expected);
+}
+
+TEST(XsmpScheduler, TimingWheel) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(100.0);
+
+  EXPECT_EQ(scheduler.GetTimingWheelTick(), 0);
+  scheduler.SetTimingWheelTick(1_ms);
+  EXPECT_EQ(scheduler.GetTimingWheelTick(), 1_ms);
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::vector<int> results;
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints,
+                         [&] { results.push_back(1); }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints,
+                         [&] { results.push_back(2); }};
+  ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints,
+                         [&] { results.push_back(3); }};
+
+  // aligned on the tick: scheduled in the timing wheel
+  scheduler.AddSimulationTimeEvent(&ep1, 1_ms, 2_ms, -1);
+  // not aligned on the tick: scheduled in the ordered table
+  scheduler.AddSimulationTimeEvent(&ep2, 1_ms, 1500_us, -1);
+  scheduler.AddSimulationTimeEvent(&ep3, 2_ms, 0, 0);
+
+  sim.Run(4_ms);
+
+  EXPECT_EQ(sim.GetTimeKeeper()->GetSimulationTime(), 4_ms);
+  EXPECT_EQ(scheduler.GetNextScheduledEventTime(), 5_ms);
+
+  // disabling the timing wheel keeps the scheduled events
+  scheduler.SetTimingWheelTick(0);
+  EXPECT_EQ(scheduler.GetNextScheduledEventTime(), 5_ms);
+
+  const std::vector<int> expected = {1, 2, 3, 2, 1, 2};
+  EXPECT_EQ(results, expected);
+}
+
+TEST(XsmpScheduler, Lookahead) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(100.0);
+  scheduler.SetTimingWheelTick(1_ms);
+  scheduler.SetRateGroupCoalescing(true);
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::vector<int> results;
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints,
+                         [&] { results.push_back(1); }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints,
+                         [&] { results.push_back(2); }};
+  ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints,
+                         [&] { results.push_back(3); }};
+
+  // only the internal hold event is scheduled
+  EXPECT_TRUE(scheduler.GetNextEvents(10).empty());
+
+  // a rate group in the timing wheel, an event in the ordered table and an
+  // immediate event
+  const auto id1 = scheduler.AddSimulationTimeEvent(&ep1, 1_ms, 1_ms, -1);
+  const auto id2 = scheduler.AddSimulationTimeEvent(&ep2, 1_ms, 1_ms, -1);
+  const auto id3 = scheduler.AddSimulationTimeEvent(&ep3, 1500_us, 0, 0);
+  const auto id4 = scheduler.AddImmediateEvent(&ep3);
+
+  // only the next occurrence of the cyclic events is reported
+  auto events = scheduler.GetNextEvents(10);
+  ASSERT_EQ(events.size(), 4);
+  EXPECT_EQ(events[0].time, 0);
+  EXPECT_EQ(events[0].eventId, id4);
+  EXPECT_EQ(events[0].entryPoint, &ep3);
+  EXPECT_EQ(events[1].time, 1_ms);
+  EXPECT_EQ(events[1].eventId, id1);
+  EXPECT_EQ(events[1].entryPoint, &ep1);
+  EXPECT_EQ(events[2].time, 1_ms);
+  EXPECT_EQ(events[2].eventId, id2);
+  EXPECT_EQ(events[3].time, 1500_us);
+  EXPECT_EQ(events[3].eventId, id3);
+  EXPECT_EQ(scheduler.GetNextEvents(2).size(), 2);
+
+  // the published operations keep a snapshot
+  EXPECT_EQ(scheduler.Lookahead(3), 3);
+  EXPECT_EQ(scheduler.GetLookaheadTime(2), 1_ms);
+  EXPECT_EQ(scheduler.GetLookaheadEventId(2), id2);
+  EXPECT_STREQ(scheduler.GetLookaheadEntryPoint(2), "/entryPoints.ep2");
+  EXPECT_THROW(scheduler.GetLookaheadTime(3), ::Smp::Exception);
+  EXPECT_THROW(scheduler.GetLookaheadTime(-1), ::Smp::Exception);
+
+  // step from one event time to the next one
+  EXPECT_EQ(scheduler.RunToNextEvent(), 1_ms);
+  EXPECT_EQ(sim.GetState(), ::Smp::SimulatorStateKind::SSK_Standby);
+  std::vector<int> expected = {3, 1, 2};
+  EXPECT_EQ(results, expected);
+  EXPECT_EQ(scheduler.RunToNextEvent(), 1500_us);
+  EXPECT_EQ(scheduler.RunToNextEvent(), 2_ms);
+  expected = {3, 1, 2, 3, 1, 2};
+  EXPECT_EQ(results, expected);
+
+  // nothing left to step to
+  scheduler.RemoveEvent(id1);
+  scheduler.RemoveEvent(id2);
+  EXPECT_EQ(scheduler.RunToNextEvent(), 2_ms);
+  EXPECT_EQ(sim.GetState(), ::Smp::SimulatorStateKind::SSK_Standby);
+}
+
+TEST(XsmpScheduler, Step) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetFreeRunning(true);
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::vector<::Smp::Duration> times;
+  ::Xsmp::EntryPoint ep{"ep", "", &entryPoints, [&] {
+                          times.push_back(
+                              sim.GetTimeKeeper()->GetSimulationTime());
+                        }};
+  scheduler.AddSimulationTimeEvent(&ep, 1_ms, 2_ms, -1);
+
+  // the events scheduled at the target time are executed
+  EXPECT_EQ(scheduler.Step(3_ms), 3_ms);
+  EXPECT_EQ(sim.GetState(), ::Smp::SimulatorStateKind::SSK_Standby);
+  std::vector<::Smp::Duration> expected = {1_ms, 3_ms};
+  EXPECT_EQ(times, expected);
+
+  // the simulation time is reached without any event
+  EXPECT_EQ(scheduler.RunUntil(4_ms), 4_ms);
+  EXPECT_EQ(sim.GetTimeKeeper()->GetSimulationTime(), 4_ms);
+  EXPECT_EQ(scheduler.Step(0), 4_ms);
+  EXPECT_EQ(times, expected);
+
+  // no hold event is left behind
+  EXPECT_EQ(scheduler.GetNextScheduledEventTime(), 5_ms);
+  EXPECT_EQ(scheduler.Step(2_ms), 6_ms);
+  expected = {1_ms, 3_ms, 5_ms};
+  EXPECT_EQ(times, expected);
+
+  EXPECT_THROW(scheduler.RunUntil(5_ms), ::Smp::Services::InvalidEventTime);
+  EXPECT_THROW(scheduler.Step(-1_ms), ::Smp::Services::InvalidEventTime);
+
+  // a hold requested by the model stops the step
+  ::Xsmp::EntryPoint hold{"hold", "", &entryPoints, [&] { sim.Hold(true); }};
+  scheduler.AddSimulationTimeEvent(&hold, 1_ms, 0, 0);
+  EXPECT_EQ(scheduler.Step(10_ms), 7_ms);
+  EXPECT_EQ(scheduler.Step(10_ms), 17_ms);
+  expected = {1_ms, 3_ms, 5_ms, 7_ms, 9_ms, 11_ms, 13_ms, 15_ms, 17_ms};
+  EXPECT_EQ(times, expected);
+
+  // the simulator refuses to run during a state transition
+  int refused = 0;
+  ::Xsmp::EntryPoint nested{"nested", "", &entryPoints, [&] {
+                              EXPECT_THROW(scheduler.Step(1_ms),
+                                           ::Smp::InvalidSimulatorState);
+                              ++refused;
+                            }};
+  auto *eventManager = sim.GetEventManager();
+  eventManager->Subscribe(::Smp::Services::IEventManager::SMP_EnterStandbyId,
+                          &nested);
+  EXPECT_EQ(scheduler.Step(1_ms), 18_ms);
+  eventManager->Unsubscribe(::Smp::Services::IEventManager::SMP_EnterStandbyId,
+                            &nested);
+  EXPECT_EQ(refused, 1);
+  EXPECT_EQ(scheduler.Step(2_ms), 20_ms);
+  expected.push_back(19_ms);
+  EXPECT_EQ(times, expected);
+}
+
+TEST(XsmpScheduler, ParallelExecution) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(100.0);
+
+  EXPECT_EQ(scheduler.GetExecutionThreads(), 0);
+  scheduler.SetExecutionThreads(4);
+  EXPECT_EQ(scheduler.GetExecutionThreads(), 4);
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::mutex mutex;
+  std::vector<int> results;
+  std::atomic<int> running{0};
+  std::atomic<int> maxRunning{0};
+  auto work = [&](int value) {
+    const auto current = ++running;
+    auto max = maxRunning.load();
+    while (current > max && !maxRunning.compare_exchange_weak(max, current)) {
+    }
+    // the first tasks of the parallel segment wait for each other
+    if (value != 5) {
+      WaitUntil([&maxRunning] { return maxRunning >= 2; });
+    }
+    {
+      const std::scoped_lock lck{mutex};
+      results.push_back(value);
+    }
+    --running;
+  };
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints, [&] { work(1); }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints, [&] { work(2); }};
+  ::Xsmp::EntryPoint ep3{"ep3", "", &entryPoints, [&] { work(3); }};
+  ::Xsmp::EntryPoint ep4{"ep4", "", &entryPoints, [&] { work(4); }};
+  ::Xsmp::EntryPoint ep5{"ep5", "", &entryPoints, [&] { work(5); }};
+
+  scheduler.SetExecutionGroup(&ep1, 1);
+  scheduler.SetExecutionGroup(&ep2, 1);
+  scheduler.SetExecutionGroup(&ep3, 2);
+  scheduler.SetExecutionGroup(&ep4, 2);
+  EXPECT_EQ(scheduler.GetExecutionGroup(&ep3), 2);
+  EXPECT_EQ(scheduler.GetExecutionGroup(&ep5), 0);
+
+  scheduler.AddSimulationTimeEvent(&ep2, 1_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep3, 1_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep1, 1_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep4, 1_ms, 0, 0);
+  // an entry point without group is a barrier
+  scheduler.AddSimulationTimeEvent(&ep5, 1_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep1, 1_ms, 0, 0);
+
+  sim.Run(2_ms);
+
+  ASSERT_EQ(results.size(), 6);
+  EXPECT_GE(maxRunning, 2);
+
+  // posting order is kept inside each group
+  std::vector<int> group1;
+  std::vector<int> group2;
+  std::copy_if(results.begin(), results.begin() + 4,
+               std::back_inserter(group1), [](int v) { return v <= 2; });
+  std::copy_if(results.begin(), results.begin() + 4,
+               std::back_inserter(group2), [](int v) { return v >= 3; });
+  EXPECT_EQ(group1, (std::vector<int>{2, 1}));
+  EXPECT_EQ(group2, (std::vector<int>{3, 4}));
+  EXPECT_EQ(results[4], 5);
+  EXPECT_EQ(results[5], 1);
+
+  scheduler.SetExecutionThreads(1);
+  EXPECT_EQ(scheduler.GetExecutionThreads(), 0);
+}
+
+TEST(XsmpScheduler, SetExecutionThreadsFromEntryPoint) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(100.0);
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::atomic<int> count{0};
+  ::Xsmp::EntryPoint enable{"enable", "", &entryPoints,
+                            [&] { scheduler.SetExecutionThreads(4); }};
+  ::Xsmp::EntryPoint disable{"disable", "", &entryPoints,
+                             [&] { scheduler.SetExecutionThreads(0); }};
+  ::Xsmp::EntryPoint ep1{"ep1", "", &entryPoints, [&] { ++count; }};
+  ::Xsmp::EntryPoint ep2{"ep2", "", &entryPoints, [&] { ++count; }};
+  scheduler.SetExecutionGroup(&ep1, 1);
+  scheduler.SetExecutionGroup(&ep2, 2);
+
+  // the new threads are used from the next simulation time
+  scheduler.AddSimulationTimeEvent(&enable, 1_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep1, 1_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep2, 1_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep1, 2_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep2, 2_ms, 0, 0);
+  // release the threads while they are executing events of the same time
+  scheduler.AddSimulationTimeEvent(&disable, 3_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep1, 3_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep2, 3_ms, 0, 0);
+  scheduler.AddSimulationTimeEvent(&ep1, 4_ms, 0, 0);
+
+  sim.Run(5_ms);
+
+  EXPECT_EQ(count, 7);
+  EXPECT_EQ(scheduler.GetExecutionThreads(), 0);
+}
+
+TEST(XsmpScheduler, ConcurrentImmediateEvents) {
+
+  Simulator sim;
+  sim.LoadLibrary("xsmp_services");
+  sim.Connect();
+  auto &scheduler =
+      *dynamic_cast<Services::XsmpScheduler *>(sim.GetScheduler());
+  scheduler.SetTargetSpeed(100.0);
+
+  TestEntryPointPublisher entryPoints{"entryPoints", "", &sim};
+  std::size_t count = 0;
+  ::Xsmp::EntryPoint ep{"ep", "", &entryPoints, [&] { ++count; }};
+
+  constexpr std::size_t threadCount = 4;
+  constexpr std::size_t eventCount = 1000;
+  std::vector<std::vector<::Smp::Services::EventId>> ids(threadCount);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < threadCount; ++i) {
+    threads.emplace_back([&scheduler, &ep, &eventIds = ids[i]] {
+      for (std::size_t j = 0; j < eventCount; ++j) {
+        eventIds.push_back(scheduler.AddImmediateEvent(&ep));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // the ids are unique and increasing for each thread
+  std::vector<::Smp::Services::EventId> all;
+  for (const auto &eventIds : ids) {
+    EXPECT_TRUE(std::is_sorted(eventIds.begin(), eventIds.end()));
+    all.insert(all.end(), eventIds.begin(), eventIds.end());
+  }
+  std::sort(all.begin(), all.end());
+  EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+
+  // a queued immediate event can be removed
+  EXPECT_NO_THROW(scheduler.RemoveEvent(ids[0][0]));
+  EXPECT_THROW(scheduler.RemoveEvent(ids[0][0]),
+               ::Smp::Services::InvalidEventId);
+
+  sim.Run(1_ms);
+  EXPECT_EQ(count, threadCount * eventCount - 1);
+}
+
 } // namespace Xsmp::Services